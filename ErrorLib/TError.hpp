@@ -15,13 +15,13 @@ public:
   void what();
 };
 
-TError::TError(const std::string& error_, const std::string& function_, const std::string& file_, int line_)
+inline TError::TError(const std::string& error_, const std::string& function_, const std::string& file_, int line_)
   : error(error_), function(function_), file(file_), line(line_)
 {
   std::cout << "\nError: " << error << " Function: " << function << " File: " << file << " Line:" << line << std::endl;
 }
 
-void TError::what()
+inline void TError::what()
 {
 	std::cout << "\nError: " << error << "Function: " << function << "File: " << file << "Line:" << line << std::endl;
 }
@@ -0,0 +1,92 @@
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TConcurrentMultiStack.h"
+#include "TMultiStack.h"
+
+template<class F>
+double Measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+// Baseline: one TMultiStack behind one mutex.
+class TLockedMultiStack {
+    std::mutex mutex;
+    TMultiStack<int> stack;
+
+public:
+    TLockedMultiStack(size_t count_stacks, size_t capacity_stack) : stack(count_stacks, capacity_stack) {}
+
+    void Push(size_t i, int value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stack.Push(i, value);
+    }
+
+    int Pop(size_t i)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stack.Pop(i);
+    }
+};
+
+// Every thread works on its own stacks: pushes a burst, pops it back. A burst
+// that fits into a stack stays on the per-stack locks; a larger one overflows
+// its stack on every round and goes through the exclusive repack.
+template<class S>
+double Run(S& stack, size_t threads_count, size_t stacks_per_thread, size_t rounds, size_t burst)
+{
+    return Measure([&] {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threads_count; ++t) {
+            threads.emplace_back([&stack, t, stacks_per_thread, rounds, burst] {
+                for (size_t r = 0; r < rounds; ++r) {
+                    size_t i = t * stacks_per_thread + r % stacks_per_thread;
+                    for (size_t k = 0; k < burst; ++k) stack.Push(i, static_cast<int>(k));
+                    for (size_t k = 0; k < burst; ++k) stack.Pop(i);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    });
+}
+
+// Runs both multistacks with the given burst for 1, 2, 4 and 8 threads. Whether
+// the per-stack locks scale can only be seen on a machine with at least as many
+// cores as threads; with fewer cores the threads just take turns.
+void Compare(const char* name, size_t stacks_per_thread, size_t capacity_stack, size_t rounds, size_t burst)
+{
+    std::cout << name << ": burst " << burst << ", stack capacity " << capacity_stack << ", "
+              << rounds * burst * 2 << " operations per thread\n";
+    for (size_t threads : { 1, 2, 4, 8 }) {
+        TLockedMultiStack locked(threads * stacks_per_thread, capacity_stack);
+        TConcurrentMultiStack<int> concurrent(threads * stacks_per_thread, capacity_stack);
+
+        double total = static_cast<double>(threads * rounds * burst * 2);
+        double t_locked = Run(locked, threads, stacks_per_thread, rounds, burst);
+        double t_concurrent = Run(concurrent, threads, stacks_per_thread, rounds, burst);
+
+        std::cout << "  " << threads << " threads: "
+                  << "single lock " << total / t_locked / 1000 << " Mops/s, "
+                  << "per-stack locks " << total / t_concurrent / 1000 << " Mops/s" << std::endl;
+    }
+}
+
+int main()
+{
+    const size_t stacks_per_thread = 16;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    if (std::thread::hardware_concurrency() < 8)
+        std::cout << "fewer cores than threads: the results below do not show scaling\n";
+    Compare("burst fits", stacks_per_thread, 64, 50000, 16);
+    Compare("burst overflows", stacks_per_thread, 8, 5000, 24);
+    return 0;
+}
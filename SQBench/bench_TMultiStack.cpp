@@ -0,0 +1,114 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+#include "TMappedMultiStack.h"
+#include "TMultiStack.h"
+
+template<class F>
+double Measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+int main()
+{
+    const size_t count_stacks = 10000;
+    const size_t capacity_stack = 8;
+    const size_t queries = 100000;
+    const size_t count_pushes = 20000;
+
+    TMultiStack<int> stack(count_stacks, capacity_stack);
+    std::mt19937 gen(1);
+
+    // Skewed pushes: every tenth stack takes most of the elements, so Push keeps
+    // hitting full stacks and repacking.
+    double push_time = Measure([&] {
+        for (size_t p = 0; p < count_pushes; ++p) {
+            size_t i = gen() % 4 != 0 ? gen() % (count_stacks / 10) * 10 : gen() % count_stacks;
+            stack.Push(i, static_cast<int>(p));
+        }
+    });
+
+    // Push to a random stack, Pop from another: occupancy stays where the fill
+    // left it and the time goes into the begin/top lookups of IsFull/IsEmpty.
+    const size_t count_ops = 2000000;
+    long long check_ops = 0;
+    double ops_time = Measure([&] {
+        for (size_t p = 0; p < count_ops; p += 2) {
+            size_t i = gen() % count_stacks;
+            stack.Push(i, static_cast<int>(p));
+            size_t j = gen() % count_stacks;
+            check_ops += stack.Pop(stack.IsEmpty(j) ? i : j);
+        }
+    });
+
+    size_t check_running = 0;
+    size_t check_summed = 0;
+
+    double running = Measure([&] {
+        for (size_t q = 0; q < queries; ++q) check_running += stack.GetSize_M() + stack.IsFull_M() + stack.IsEmpty_M();
+    });
+
+    // What GetSize_M used to cost: a walk over every stack.
+    double summed = Measure([&] {
+        for (size_t q = 0; q < queries / 100; ++q) {
+            size_t size = 0;
+            for (size_t i = 0; i < count_stacks; ++i) size += stack.GetSizeOfStack(i);
+            check_summed += size + (size == stack.GetCapacity_M()) + (size == 0);
+        }
+    });
+
+    std::cout << "stacks = " << count_stacks << ", capacity = " << stack.GetCapacity_M() << "\n";
+    std::cout << count_pushes << " skewed pushes: " << push_time << " ms\n";
+    std::cout << count_ops << " random Push/Pop: " << ops_time << " ms (" << check_ops % 10 << ")\n";
+    std::cout << "GetSize_M + IsFull_M + IsEmpty_M, running total: " << running * 1e6 / queries << " ns per query\n";
+    std::cout << "GetSize_M + IsFull_M + IsEmpty_M, summed stacks: " << summed * 1e6 / (queries / 100) << " ns per query\n";
+    std::cout << "checksum " << (check_running / queries == check_summed / (queries / 100) ? "ok" : "MISMATCH") << std::endl;
+
+    // One hot stack in the middle of half-full neighbours: every overflow has
+    // to take slots from stacks that hold elements, and a borrow that shifts
+    // them for a few slots would make each push cost O(size).
+    const size_t hot_pushes = 30000;
+    TMultiStack<int> hot(count_stacks, capacity_stack);
+    for (size_t i = 0; i < count_stacks; ++i) {
+        for (size_t j = 0; j < capacity_stack / 2; ++j) hot.Push(i, static_cast<int>(j));
+    }
+    double hot_time = Measure([&] {
+        for (size_t p = 0; p < hot_pushes; ++p) hot.Push(count_stacks / 2, static_cast<int>(p));
+    });
+    std::cout << hot_pushes << " pushes to one stack: " << hot_time << " ms (" << hot.GetSizeOfStack(count_stacks / 2) << ")\n";
+
+    // Checkpoint of a big multistack at 1% occupancy: the full file carries every
+    // free slot, the compact one only the elements.
+    TMultiStack<int> big(1000, 10000);
+    for (size_t p = 0; p < big.GetCapacity_M() / 100; ++p) big.Push(gen() % 1000, static_cast<int>(p));
+    const std::string filename = "bench_multistack.bin";
+    for (bool compact : { false, true }) {
+        double save_time = Measure([&] { big.SaveToFile(filename, compact); });
+        size_t loaded_size = 0;
+        double load_time = Measure([&] { loaded_size = TMultiStack<int>(filename).GetSize_M(); });
+        std::cout << (compact ? "compact" : "full") << " checkpoint of " << big.GetSize_M() << " / " << big.GetCapacity_M()
+                  << ": save " << save_time << " ms, load " << load_time << " ms"
+                  << (loaded_size == big.GetSize_M() ? "" : " (MISMATCH)") << std::endl;
+    }
+    std::remove(filename.c_str());
+
+    // The same multistack kept in a mapped file: a restart only maps the file
+    // and checks the stack bounds, the elements are paged in when touched.
+    {
+        TMappedMultiStack<int> mapped(filename, 1000, 10000);
+        for (size_t p = 0; p < mapped.GetCapacity_M() / 100; ++p) mapped.Push(gen() % 1000, static_cast<int>(p));
+        double sync_time = Measure([&] { mapped.Sync(); });
+        std::cout << "mapped checkpoint (msync): " << sync_time << " ms\n";
+    }
+    size_t mapped_size = 0;
+    double open_time = Measure([&] { mapped_size = TMappedMultiStack<int>(filename).GetSize_M(); });
+    std::cout << "mapped open of " << mapped_size << " / " << big.GetCapacity_M() << ": " << open_time << " ms" << std::endl;
+    std::remove(filename.c_str());
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <chrono>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "TPriorityQueue.h"
+
+template<class F>
+double Measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+int main()
+{
+    const size_t n = 1000000;
+    std::vector<int> values(n);
+    std::mt19937 gen(1);
+    for (auto& v : values) v = static_cast<int>(gen());
+
+    long long check_std = 0;
+    long long check_t = 0;
+
+    double std_push_pop = Measure([&] {
+        std::priority_queue<int> queue;
+        for (int v : values) queue.push(v);
+        while (!queue.empty()) {
+            check_std += queue.top();
+            queue.pop();
+        }
+    });
+
+    double t_push_pop = Measure([&] {
+        TPriorityQueue<int> queue;
+        for (int v : values) queue.Put(v);
+        while (!queue.IsEmpty()) check_t += queue.Get();
+    });
+
+    double std_heapify = Measure([&] {
+        std::priority_queue<int> queue(values.begin(), values.end());
+        check_std += queue.top();
+    });
+
+    double t_heapify = Measure([&] {
+        TPriorityQueue<int> queue(values.begin(), values.end());
+        check_t += queue.Top();
+    });
+
+    std::cout << "n = " << n << "\n";
+    std::cout << "push + pop:  std::priority_queue " << std_push_pop << " ms, TPriorityQueue " << t_push_pop << " ms\n";
+    std::cout << "heapify:     std::priority_queue " << std_heapify << " ms, TPriorityQueue " << t_heapify << " ms\n";
+    std::cout << "checksum " << (check_std == check_t ? "ok" : "MISMATCH") << std::endl;
+    return 0;
+}
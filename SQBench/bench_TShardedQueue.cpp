@@ -0,0 +1,98 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TQueue.h"
+#include "TShardedQueue.h"
+
+template<class F>
+double Measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+// Baseline: one TQueue behind one mutex.
+class TLockedQueue {
+    std::mutex mutex;
+    TQueue<int> queue;
+
+public:
+    TLockedQueue(size_t capacity) : queue(capacity) {}
+
+    bool TryPut(int value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.IsFull()) return false;
+        queue.Put(value);
+        return true;
+    }
+
+    bool TryGet(int& value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.IsEmpty()) return false;
+        value = queue.Get();
+        return true;
+    }
+};
+
+template<class Q>
+double Run(Q& queue, size_t producers, size_t consumers, size_t per_producer)
+{
+    return Measure([&] {
+        std::atomic<size_t> consumed(0);
+        size_t total = producers * per_producer;
+        std::vector<std::thread> threads;
+
+        for (size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&queue, per_producer] {
+                for (size_t i = 0; i < per_producer; ++i) {
+                    while (!queue.TryPut(static_cast<int>(i))) std::this_thread::yield();
+                }
+            });
+        }
+        for (size_t c = 0; c < consumers; ++c) {
+            threads.emplace_back([&queue, &consumed, total] {
+                int value;
+                while (consumed.load(std::memory_order_relaxed) < total) {
+                    if (queue.TryGet(value)) consumed.fetch_add(1, std::memory_order_relaxed);
+                    else std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    });
+}
+
+int main()
+{
+    const size_t per_producer = 200000;
+    const size_t capacity = 1 << 16;
+    size_t lanes = std::thread::hardware_concurrency();
+    if (lanes == 0) lanes = 1;
+
+    std::cout << "lanes: " << lanes << ", " << per_producer << " elements per producer\n";
+    for (size_t producers : { 1, 2, 4, 8, 16 }) {
+        size_t consumers = producers < 4 ? producers : 4;
+        TLockedQueue locked(capacity);
+        TShardedQueue<int> affinity(capacity, lanes, TLaneSelection::Affinity);
+        TShardedQueue<int> round_robin(capacity, lanes, TLaneSelection::RoundRobin);
+
+        double total = static_cast<double>(producers * per_producer);
+        double t_locked = Run(locked, producers, consumers, per_producer);
+        double t_affinity = Run(affinity, producers, consumers, per_producer);
+        double t_round_robin = Run(round_robin, producers, consumers, per_producer);
+
+        std::cout << producers << " producers / " << consumers << " consumers: "
+                  << "single lock " << total / t_locked / 1000 << " Mops/s, "
+                  << "sharded affinity " << total / t_affinity / 1000 << " Mops/s, "
+                  << "sharded round-robin " << total / t_round_robin / 1000 << " Mops/s" << std::endl;
+    }
+    return 0;
+}
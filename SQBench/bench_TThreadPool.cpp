@@ -0,0 +1,79 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "TThreadPool.h"
+
+template<class F>
+double Measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+long long FibSequential(int n)
+{
+    return n < 2 ? n : FibSequential(n - 1) + FibSequential(n - 2);
+}
+
+long long FibParallel(TThreadPool& pool, int n)
+{
+    if (n < 20) return FibSequential(n);
+    long long a = 0, b = 0;
+    pool.Invoke([&] { a = FibParallel(pool, n - 1); }, [&] { b = FibParallel(pool, n - 2); });
+    return a + b;
+}
+
+void QuickSort(TThreadPool* pool, int* first, int* last)
+{
+    while (last - first > 1) {
+        int pivot = first[(last - first) / 2];
+        int* left = first;
+        int* right = last - 1;
+        while (left <= right) {
+            while (*left < pivot) ++left;
+            while (*right > pivot) --right;
+            if (left <= right) std::swap(*left++, *right--);
+        }
+        if (pool && last - first > 10000) {
+            int* middle = left;
+            pool->Invoke([=] { QuickSort(pool, first, right + 1); }, [=] { QuickSort(pool, middle, last); });
+            return;
+        }
+        QuickSort(pool, first, right + 1);
+        first = left;
+    }
+}
+
+int main()
+{
+    const int fib_n = 34;
+    const size_t sort_n = 4000000;
+    TThreadPool pool;
+
+    long long fib_seq = 0, fib_par = 0;
+    double t_fib_seq = Measure([&] { fib_seq = FibSequential(fib_n); });
+    double t_fib_par = Measure([&] { fib_par = FibParallel(pool, fib_n); });
+
+    std::vector<int> values(sort_n);
+    unsigned state = 1;
+    for (auto& v : values) v = static_cast<int>(state = state * 1103515245u + 12345u);
+    std::vector<int> copy = values;
+
+    double t_sort_seq = Measure([&] { QuickSort(nullptr, values.data(), values.data() + values.size()); });
+    double t_sort_par = Measure([&] { QuickSort(&pool, copy.data(), copy.data() + copy.size()); });
+
+    std::vector<double> squares(sort_n);
+    double t_for_seq = Measure([&] { for (size_t i = 0; i < sort_n; ++i) squares[i] = double(i) * i; });
+    double t_for_par = Measure([&] { pool.ParallelFor(0, sort_n, 16384, [&](size_t i) { squares[i] = double(i) * i; }); });
+
+    std::cout << "threads: " << pool.GetCountThreads() << "\n";
+    std::cout << "fib(" << fib_n << "):       sequential " << t_fib_seq << " ms, pool " << t_fib_par << " ms"
+              << (fib_seq == fib_par ? "" : " MISMATCH") << "\n";
+    std::cout << "quicksort " << sort_n << ": sequential " << t_sort_seq << " ms, pool " << t_sort_par << " ms"
+              << (values == copy ? "" : " MISMATCH") << "\n";
+    std::cout << "parallel for " << sort_n << ": sequential " << t_for_seq << " ms, pool " << t_for_par << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,361 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <string>
+
+#include "TError.hpp"
+#include "TQueue.h"
+
+// Token bucket: holds up to burst tokens and gains rate tokens per second.
+// Every admitted element takes one token. rate <= 0 means no limit.
+class TTokenBucket {
+public:
+	using TClock = std::chrono::steady_clock;
+
+protected:
+	double rate;
+	double burst;
+	double tokens;
+	TClock::time_point last;
+
+	void Refill(TClock::time_point now);
+
+public:
+	TTokenBucket(double rate_ = 0, double burst_ = 1, TClock::time_point now = TClock::now());
+
+	bool IsUnlimited() const;
+	double GetTokens(TClock::time_point now = TClock::now());
+
+	bool TryTake(TClock::time_point now = TClock::now());
+	TClock::duration TimeToToken(TClock::time_point now = TClock::now());
+};
+
+inline TTokenBucket::TTokenBucket(double rate_, double burst_, TClock::time_point now)
+	: rate(rate_), burst(burst_ < 1 ? 1 : burst_), tokens(burst_ < 1 ? 1 : burst_), last(now) {}
+
+inline void TTokenBucket::Refill(TClock::time_point now)
+{
+	if (now <= last) return;
+	tokens += rate * std::chrono::duration<double>(now - last).count();
+	if (tokens > burst) tokens = burst;
+	last = now;
+}
+
+inline bool TTokenBucket::IsUnlimited() const
+{
+	return rate <= 0;
+}
+
+inline double TTokenBucket::GetTokens(TClock::time_point now)
+{
+	if (IsUnlimited()) return burst;
+	Refill(now);
+	return tokens;
+}
+
+inline bool TTokenBucket::TryTake(TClock::time_point now)
+{
+	if (IsUnlimited()) return true;
+	Refill(now);
+	if (tokens < 1) return false;
+	tokens -= 1;
+	return true;
+}
+
+inline TTokenBucket::TClock::duration TTokenBucket::TimeToToken(TClock::time_point now)
+{
+	if (IsUnlimited()) return TClock::duration::zero();
+	Refill(now);
+	if (tokens >= 1) return TClock::duration::zero();
+	auto wait = std::chrono::duration<double>((1 - tokens) / rate);
+	return std::chrono::duration_cast<TClock::duration>(wait) + TClock::duration(1);
+}
+
+// What a TAdmissionQueue does with an element it can't take right away:
+// DropOldest  - queue full: evict the oldest element; no token: reject.
+// DropNewest  - queue full or no token: reject the new element.
+// Block       - wait for a token and for a free slot.
+// SpillToDisk - queue full: append the element to a spill file; it is moved
+//               back into the queue as Get frees slots, so FIFO order is kept.
+//               No token: reject. Only admitted elements are spilled, so the
+//               reload doesn't take another token and the rate still holds.
+enum class TOverflowPolicy { DropOldest, DropNewest, Block, SpillToDisk };
+
+enum class TAdmission { Accepted, DroppedOldest, DroppedNewest, RateLimited, Spilled, Closed };
+
+struct TAdmissionCounters {
+	size_t accepted = 0;
+	size_t dropped_oldest = 0;
+	size_t dropped_newest = 0;
+	size_t rate_limited = 0;
+	size_t blocked = 0;
+	size_t spilled = 0;
+	size_t unspilled = 0;
+};
+
+// Thread-safe admission layer over TQueue. Put never throws on overload: it
+// rate-limits through a TTokenBucket and applies the overflow policy, returns
+// what happened to the element and counts every outcome. Spilled elements are
+// written as text with operator<< and read back with operator>>, like
+// TQueue::SaveToFile. After Close() Put is refused and Get drains what is left.
+template<class T>
+class TAdmissionQueue {
+protected:
+	TQueue<T> queue;
+	TOverflowPolicy policy;
+	TTokenBucket bucket;
+	TAdmissionCounters counters;
+	bool closed;
+	size_t waiting_put;
+	size_t waiting_get;
+
+	std::string spill_path;
+	std::ofstream spill_out;
+	std::ifstream spill_in;
+	std::streampos spill_read_pos;
+	size_t spill_count;
+
+	mutable std::mutex mutex;
+	std::condition_variable not_empty;
+	std::condition_variable not_full;
+
+	void Spill(const T& value);
+	void Unspill();
+	void PutLocked(const T& value);
+	bool GetLocked(T& value);
+
+public:
+	TAdmissionQueue(size_t capacity_, TOverflowPolicy policy_, double rate = 0, double burst = 1,
+		const std::string& spill_path_ = "");
+	TAdmissionQueue(const TAdmissionQueue<T>& other) = delete;
+	TAdmissionQueue& operator=(const TAdmissionQueue<T>& other) = delete;
+	~TAdmissionQueue();
+
+	size_t GetSize() const;
+	size_t GetSpilledSize() const;
+	size_t GetCapacity() const;
+	TOverflowPolicy GetPolicy() const;
+	TAdmissionCounters GetCounters() const;
+
+	bool IsEmpty() const;
+	bool IsClosed() const;
+
+	TAdmission Put(const T& value);
+	bool Get(T& value);
+	bool TryGet(T& value);
+
+	void Close();
+};
+
+template<class T>
+inline TAdmissionQueue<T>::TAdmissionQueue(size_t capacity_, TOverflowPolicy policy_, double rate, double burst,
+	const std::string& spill_path_)
+	: queue(capacity_), policy(policy_), bucket(rate, burst), closed(false), waiting_put(0), waiting_get(0),
+	  spill_path(spill_path_), spill_read_pos(0), spill_count(0)
+{
+	if (capacity_ == 0) throw TError("Capacity can't be 0", __func__, __FILE__, __LINE__);
+	if (policy == TOverflowPolicy::SpillToDisk && spill_path.empty())
+		throw TError("Spill file is not set", __func__, __FILE__, __LINE__);
+}
+
+template<class T>
+inline TAdmissionQueue<T>::~TAdmissionQueue()
+{
+	if (spill_out.is_open()) {
+		spill_out.close();
+		std::remove(spill_path.c_str());
+	}
+}
+
+template<class T>
+inline void TAdmissionQueue<T>::Spill(const T& value)
+{
+	if (!spill_out.is_open()) {
+		spill_out.open(spill_path, std::ios::trunc);
+		if (!spill_out.is_open()) throw TError("Cannot open file", __func__, __FILE__, __LINE__);
+		spill_out.precision(std::numeric_limits<long double>::max_digits10);
+		spill_read_pos = 0;
+	}
+	spill_out << value << "\n";
+	spill_out.flush();
+	if (!spill_out) throw TError("Cannot write spill file", __func__, __FILE__, __LINE__);
+	spill_count++;
+	counters.spilled++;
+	if (waiting_get > 0) not_empty.notify_one();
+}
+
+template<class T>
+inline void TAdmissionQueue<T>::Unspill()
+{
+	if (!spill_in.is_open()) {
+		spill_in.open(spill_path);
+		if (!spill_in.is_open()) throw TError("Cannot open file", __func__, __FILE__, __LINE__);
+	}
+	spill_in.clear();
+	spill_in.seekg(spill_read_pos);
+	T value;
+	spill_in >> value;
+	if (spill_in.fail()) throw TError("Incorrect spill file", __func__, __FILE__, __LINE__);
+	spill_read_pos = spill_in.tellg();
+	spill_count--;
+	counters.unspilled++;
+	queue.Put(value);
+
+	if (spill_count == 0) {
+		spill_in.close();
+		spill_out.close();
+		std::remove(spill_path.c_str());
+	}
+}
+
+template<class T>
+inline void TAdmissionQueue<T>::PutLocked(const T& value)
+{
+	queue.Put(value);
+	counters.accepted++;
+	if (waiting_get > 0) not_empty.notify_one();
+}
+
+template<class T>
+inline bool TAdmissionQueue<T>::GetLocked(T& value)
+{
+	if (queue.IsEmpty()) {
+		if (spill_count == 0) return false;
+		Unspill();
+	}
+
+	value = queue.Get();
+	if (spill_count > 0) Unspill();
+	else if (waiting_put > 0) not_full.notify_all();
+	return true;
+}
+
+template<class T>
+inline size_t TAdmissionQueue<T>::GetSize() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return queue.GetSize() + spill_count;
+}
+
+template<class T>
+inline size_t TAdmissionQueue<T>::GetSpilledSize() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return spill_count;
+}
+
+template<class T>
+inline size_t TAdmissionQueue<T>::GetCapacity() const
+{
+	return queue.GetCapacity();
+}
+
+template<class T>
+inline TOverflowPolicy TAdmissionQueue<T>::GetPolicy() const
+{
+	return policy;
+}
+
+template<class T>
+inline TAdmissionCounters TAdmissionQueue<T>::GetCounters() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return counters;
+}
+
+template<class T>
+inline bool TAdmissionQueue<T>::IsEmpty() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return queue.IsEmpty() && spill_count == 0;
+}
+
+template<class T>
+inline bool TAdmissionQueue<T>::IsClosed() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return closed;
+}
+
+template<class T>
+inline TAdmission TAdmissionQueue<T>::Put(const T& value)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (closed) return TAdmission::Closed;
+
+	bool blocked = false;
+	if (!bucket.TryTake()) {
+		if (policy != TOverflowPolicy::Block) {
+			counters.rate_limited++;
+			return TAdmission::RateLimited;
+		}
+
+		blocked = true;
+		counters.blocked++;
+		while (!closed && !bucket.TryTake()) not_full.wait_for(lock, bucket.TimeToToken());
+		if (closed) return TAdmission::Closed;
+	}
+
+	if (policy == TOverflowPolicy::SpillToDisk && spill_count > 0) {
+		Spill(value);
+		return TAdmission::Spilled;
+	}
+	if (!queue.IsFull()) {
+		PutLocked(value);
+		return TAdmission::Accepted;
+	}
+
+	switch (policy) {
+	case TOverflowPolicy::DropOldest:
+		queue.Get();
+		queue.Put(value);
+		counters.dropped_oldest++;
+		return TAdmission::DroppedOldest;
+	case TOverflowPolicy::DropNewest:
+		counters.dropped_newest++;
+		return TAdmission::DroppedNewest;
+	case TOverflowPolicy::SpillToDisk:
+		Spill(value);
+		return TAdmission::Spilled;
+	case TOverflowPolicy::Block:
+		break;
+	}
+
+	if (!blocked) counters.blocked++;
+	waiting_put++;
+	not_full.wait(lock, [this] { return closed || !queue.IsFull(); });
+	waiting_put--;
+	if (closed) return TAdmission::Closed;
+	PutLocked(value);
+	return TAdmission::Accepted;
+}
+
+template<class T>
+inline bool TAdmissionQueue<T>::Get(T& value)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	waiting_get++;
+	not_empty.wait(lock, [this] { return closed || !queue.IsEmpty() || spill_count > 0; });
+	waiting_get--;
+	return GetLocked(value);
+}
+
+template<class T>
+inline bool TAdmissionQueue<T>::TryGet(T& value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return GetLocked(value);
+}
+
+template<class T>
+inline void TAdmissionQueue<T>::Close()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	closed = true;
+	not_empty.notify_all();
+	not_full.notify_all();
+}
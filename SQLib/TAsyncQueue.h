@@ -0,0 +1,183 @@
+#pragma once
+#include <coroutine>
+#include <utility>
+
+#include "TDeque.h"
+#include "TExecutor.h"
+#include "TQueue.h"
+
+// Bounded channel for coroutines running on one TExecutor. co_await Get()
+// suspends the coroutine while the queue is empty and co_await Put(value) while
+// it is full; neither spins nor blocks the thread. Elements are kept in a TQueue.
+// A Put that finds a suspended getter hands the value straight to it, and a Get
+// that frees a slot moves the oldest suspended putter's value into the queue,
+// so waiters are served in FIFO order and a resumed coroutine never has to
+// recheck. Resumed coroutines are scheduled on the executor, never resumed
+// inline. Capacity 0 gives an unbuffered channel: Put waits for a Get.
+// Waiters live in coroutine frames, so a queue must not be used after the
+// executor holding its suspended coroutines has been destroyed.
+template<class T>
+class TAsyncQueue {
+public:
+	class TGetAwaiter;
+	class TPutAwaiter;
+
+protected:
+	TExecutor* executor;
+	TQueue<T> queue;
+	TDeque<TGetAwaiter*> getters;
+	TDeque<TPutAwaiter*> putters;
+
+public:
+	class TGetAwaiter {
+	private:
+		TAsyncQueue<T>* owner;
+		std::coroutine_handle<> handle;
+		T value;
+
+		friend class TAsyncQueue<T>;
+
+	public:
+		TGetAwaiter(TAsyncQueue<T>* owner_) : owner(owner_), value() {}
+
+		bool await_ready() {
+			return owner->TryGet(value);
+		}
+
+		void await_suspend(std::coroutine_handle<> handle_) {
+			handle = handle_;
+			owner->getters.PushBack(this);
+		}
+
+		T await_resume() {
+			return std::move(value);
+		}
+	};
+
+	class TPutAwaiter {
+	private:
+		TAsyncQueue<T>* owner;
+		std::coroutine_handle<> handle;
+		T value;
+
+		friend class TAsyncQueue<T>;
+
+	public:
+		TPutAwaiter(TAsyncQueue<T>* owner_, const T& value_) : owner(owner_), value(value_) {}
+
+		bool await_ready() {
+			return owner->TryPut(value);
+		}
+
+		void await_suspend(std::coroutine_handle<> handle_) {
+			handle = handle_;
+			owner->putters.PushBack(this);
+		}
+
+		void await_resume() noexcept {}
+	};
+
+	TAsyncQueue(TExecutor& executor_, size_t capacity_);
+	TAsyncQueue(const TAsyncQueue<T>& other) = delete;
+	TAsyncQueue& operator=(const TAsyncQueue<T>& other) = delete;
+
+	size_t GetSize() const;
+	size_t GetCapacity() const;
+	size_t GetCountGetters() const;
+	size_t GetCountPutters() const;
+
+	bool IsEmpty() const;
+	bool IsFull() const;
+
+	bool TryPut(const T& value);
+	bool TryGet(T& value);
+
+	TPutAwaiter Put(const T& value);
+	TGetAwaiter Get();
+};
+
+template<class T>
+inline TAsyncQueue<T>::TAsyncQueue(TExecutor& executor_, size_t capacity_) : executor(&executor_), queue(capacity_) {}
+
+template<class T>
+inline size_t TAsyncQueue<T>::GetSize() const
+{
+	return queue.GetSize();
+}
+
+template<class T>
+inline size_t TAsyncQueue<T>::GetCapacity() const
+{
+	return queue.GetCapacity();
+}
+
+template<class T>
+inline size_t TAsyncQueue<T>::GetCountGetters() const
+{
+	return getters.GetSize();
+}
+
+template<class T>
+inline size_t TAsyncQueue<T>::GetCountPutters() const
+{
+	return putters.GetSize();
+}
+
+template<class T>
+inline bool TAsyncQueue<T>::IsEmpty() const
+{
+	return queue.IsEmpty();
+}
+
+template<class T>
+inline bool TAsyncQueue<T>::IsFull() const
+{
+	return queue.IsFull();
+}
+
+template<class T>
+inline bool TAsyncQueue<T>::TryPut(const T& value)
+{
+	if (!getters.IsEmpty()) {
+		TGetAwaiter* getter = getters.PopFront();
+		getter->value = value;
+		executor->Schedule(getter->handle);
+		return true;
+	}
+	if (queue.IsFull()) return false;
+	queue.Put(value);
+	return true;
+}
+
+template<class T>
+inline bool TAsyncQueue<T>::TryGet(T& value)
+{
+	if (!queue.IsEmpty()) {
+		value = queue.Get();
+		if (!putters.IsEmpty()) {
+			TPutAwaiter* putter = putters.PopFront();
+			queue.Put(putter->value);
+			executor->Schedule(putter->handle);
+		}
+		return true;
+	}
+	if (!putters.IsEmpty()) {
+		TPutAwaiter* putter = putters.PopFront();
+		value = std::move(putter->value);
+		executor->Schedule(putter->handle);
+		return true;
+	}
+	return false;
+}
+
+template<class T>
+inline typename TAsyncQueue<T>::TPutAwaiter TAsyncQueue<T>::Put(const T& value)
+{
+	return TPutAwaiter(this, value);
+}
+
+template<class T>
+inline typename TAsyncQueue<T>::TGetAwaiter TAsyncQueue<T>::Get()
+{
+	return TGetAwaiter(this);
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include "TError.hpp"
+
+// 64-bit FNV-1a, fed incrementally: hash = Fnv1a(bytes, size, hash).
+constexpr uint64_t FNV1A_OFFSET = 0xcbf29ce484222325ull;
+constexpr uint64_t FNV1A_PRIME = 0x100000001b3ull;
+
+inline uint64_t Fnv1a(const void* bytes, size_t size, uint64_t hash = FNV1A_OFFSET)
+{
+	const unsigned char* p = static_cast<const unsigned char*>(bytes);
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= p[i];
+		hash *= FNV1A_PRIME;
+	}
+	return hash;
+}
+
+// Marker written in native byte order; reading it back reversed means the
+// file comes from a machine with the other byte order.
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304u;
+
+template<class V>
+inline V ByteSwap(V value)
+{
+	unsigned char* p = reinterpret_cast<unsigned char*>(&value);
+	std::reverse(p, p + sizeof(V));
+	return value;
+}
+
+// Binary stream writer that keeps an FNV-1a checksum of everything written,
+// continuing from checksum_ (the hash of something written before it).
+class TBinaryWriter {
+protected:
+	std::ostream& out;
+	uint64_t checksum;
+
+public:
+	TBinaryWriter(std::ostream& out_, uint64_t checksum_ = FNV1A_OFFSET) : out(out_), checksum(checksum_) {}
+
+	void Write(const void* bytes, size_t size)
+	{
+		if (size == 0) return;
+		out.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+		if (!out) throw TError("Cannot write file", __func__, __FILE__, __LINE__);
+		checksum = Fnv1a(bytes, size, checksum);
+	}
+
+	template<class V>
+	void WriteValue(const V& value)
+	{
+		static_assert(std::is_trivially_copyable<V>::value, "WriteValue writes raw bytes");
+		Write(&value, sizeof(value));
+	}
+
+	uint64_t GetChecksum() const { return checksum; }
+};
+
+// Binary stream reader that keeps an FNV-1a checksum of everything read and
+// throws on a short read. With swap set, ReadValue converts from the other byte
+// order; the checksum is always taken over the bytes as stored. GetRemaining
+// lets a reader check a length from the file before allocating for it; it is
+// unlimited on a stream that can't seek.
+class TBinaryReader {
+protected:
+	std::istream& in;
+	uint64_t checksum;
+	bool swap;
+	uint64_t remaining;
+
+public:
+	TBinaryReader(std::istream& in_, bool swap_ = false, uint64_t checksum_ = FNV1A_OFFSET)
+		: in(in_), checksum(checksum_), swap(swap_), remaining(UINT64_MAX)
+	{
+		std::streampos start = in.tellg();
+		if (start == std::streampos(-1)) return;
+		in.seekg(0, std::ios::end);
+		std::streampos finish = in.tellg();
+		in.seekg(start);
+		if (finish != std::streampos(-1)) remaining = static_cast<uint64_t>(finish - start);
+	}
+
+	void Read(void* bytes, size_t size)
+	{
+		if (size == 0) return;
+		if (size > remaining) throw TError("Unexpected end of file", __func__, __FILE__, __LINE__);
+		in.read(static_cast<char*>(bytes), static_cast<std::streamsize>(size));
+		if (!in) throw TError("Unexpected end of file", __func__, __FILE__, __LINE__);
+		remaining -= size;
+		checksum = Fnv1a(bytes, size, checksum);
+	}
+
+	template<class V>
+	V ReadValue()
+	{
+		static_assert(std::is_trivially_copyable<V>::value, "ReadValue reads raw bytes");
+		V value;
+		Read(&value, sizeof(value));
+		return swap ? ByteSwap(value) : value;
+	}
+
+	bool IsSwapped() const { return swap; }
+	uint64_t GetRemaining() const { return remaining; }
+	uint64_t GetChecksum() const { return checksum; }
+};
+
+// How one element is stored in a binary file. Trivially copyable types are
+// stored as their bytes, so a whole array may be written and read in bulk;
+// FromOtherOrder fixes up count such elements read from a file of the other
+// byte order, which is only possible for arithmetic types. Other types need a
+// specialization, like the one for std::string below.
+template<class T, class Enable = void>
+struct TElementIO {
+	static_assert(std::is_trivially_copyable<T>::value,
+		"TElementIO has to be specialized for types that are not trivially copyable");
+
+	static constexpr bool BULK = true;
+
+	static void Write(TBinaryWriter& writer, const T& value) { writer.Write(&value, sizeof(T)); }
+
+	static void Read(TBinaryReader& reader, T& value)
+	{
+		reader.Read(&value, sizeof(T));
+		if (reader.IsSwapped()) FromOtherOrder(&value, 1);
+	}
+
+	static void FromOtherOrder(T* values, size_t count)
+	{
+		if constexpr (std::is_arithmetic<T>::value) {
+			for (size_t i = 0; i < count; ++i) values[i] = ByteSwap(values[i]);
+		} else if (count > 0) {
+			throw TError("Cannot convert elements from the other byte order", __func__, __FILE__, __LINE__);
+		}
+	}
+};
+
+// Length as uint64_t followed by the characters.
+template<>
+struct TElementIO<std::string> {
+	static constexpr bool BULK = false;
+
+	static void Write(TBinaryWriter& writer, const std::string& value)
+	{
+		writer.WriteValue<uint64_t>(value.size());
+		writer.Write(value.data(), value.size());
+	}
+
+	static void Read(TBinaryReader& reader, std::string& value)
+	{
+		uint64_t length = reader.ReadValue<uint64_t>();
+		if (length > reader.GetRemaining() || length > value.max_size())
+			throw TError("Incorrect string length", __func__, __FILE__, __LINE__);
+		value.resize(static_cast<size_t>(length));
+		reader.Read(value.data(), value.size());
+	}
+};
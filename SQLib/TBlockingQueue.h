@@ -0,0 +1,253 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "TError.hpp"
+#include "TQueue.h"
+
+// Thread-safe bounded queue over TQueue storage. Put waits while the queue is full,
+// Get waits while it is empty. Waiters are woken only on empty->non-empty and
+// full->non-full transitions and only if somebody is actually waiting.
+// After Close() no new elements are accepted, Get keeps returning the remaining
+// elements and then fails.
+template<class T>
+class TBlockingQueue {
+protected:
+	TQueue<T> queue;
+	bool closed;
+	size_t waiting_put;
+	size_t waiting_get;
+	size_t waiting_drain;
+
+	mutable std::mutex mutex;
+	std::condition_variable not_empty;
+	std::condition_variable not_full;
+	std::condition_variable drained;
+
+	void PutLocked(const T& value);
+	T GetLocked();
+
+public:
+	TBlockingQueue(size_t capacity_);
+	TBlockingQueue(const TBlockingQueue<T>& other) = delete;
+	TBlockingQueue& operator=(const TBlockingQueue<T>& other) = delete;
+
+	size_t GetSize() const;
+	size_t GetCapacity() const;
+
+	bool IsEmpty() const;
+	bool IsFull() const;
+	bool IsClosed() const;
+
+	bool Put(const T& value);
+	bool Get(T& value);
+
+	bool TryPut(const T& value);
+	bool TryGet(T& value);
+
+	template<class Rep, class Period>
+	bool PutFor(const T& value, const std::chrono::duration<Rep, Period>& timeout);
+	template<class Rep, class Period>
+	bool GetFor(T& value, const std::chrono::duration<Rep, Period>& timeout);
+
+	size_t PutBatch(const T* values, size_t count_values);
+	size_t GetBatch(T* values, size_t max_count);
+
+	void Close();
+	void Drain();
+};
+
+template<class T>
+inline TBlockingQueue<T>::TBlockingQueue(size_t capacity_)
+	: queue(capacity_), closed(false), waiting_put(0), waiting_get(0), waiting_drain(0)
+{
+	if (capacity_ == 0) throw TError("Capacity can't be 0", __func__, __FILE__, __LINE__);
+}
+
+template<class T>
+inline void TBlockingQueue<T>::PutLocked(const T& value)
+{
+	bool was_empty = queue.IsEmpty();
+	queue.Put(value);
+	if (was_empty && waiting_get > 0) not_empty.notify_all();
+}
+
+template<class T>
+inline T TBlockingQueue<T>::GetLocked()
+{
+	bool was_full = queue.IsFull();
+	T value = queue.Get();
+	if (was_full && waiting_put > 0) not_full.notify_all();
+	if (queue.IsEmpty() && waiting_drain > 0) drained.notify_all();
+	return value;
+}
+
+template<class T>
+inline size_t TBlockingQueue<T>::GetSize() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return queue.GetSize();
+}
+
+template<class T>
+inline size_t TBlockingQueue<T>::GetCapacity() const
+{
+	return queue.GetCapacity();
+}
+
+template<class T>
+inline bool TBlockingQueue<T>::IsEmpty() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return queue.IsEmpty();
+}
+
+template<class T>
+inline bool TBlockingQueue<T>::IsFull() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return queue.IsFull();
+}
+
+template<class T>
+inline bool TBlockingQueue<T>::IsClosed() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return closed;
+}
+
+template<class T>
+inline bool TBlockingQueue<T>::Put(const T& value)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!closed && queue.IsFull()) {
+		++waiting_put;
+		not_full.wait(lock, [this] { return closed || !queue.IsFull(); });
+		--waiting_put;
+	}
+	if (closed) return false;
+	PutLocked(value);
+	return true;
+}
+
+template<class T>
+inline bool TBlockingQueue<T>::Get(T& value)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!closed && queue.IsEmpty()) {
+		++waiting_get;
+		not_empty.wait(lock, [this] { return closed || !queue.IsEmpty(); });
+		--waiting_get;
+	}
+	if (queue.IsEmpty()) return false;
+	value = GetLocked();
+	return true;
+}
+
+template<class T>
+inline bool TBlockingQueue<T>::TryPut(const T& value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (closed || queue.IsFull()) return false;
+	PutLocked(value);
+	return true;
+}
+
+template<class T>
+inline bool TBlockingQueue<T>::TryGet(T& value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (queue.IsEmpty()) return false;
+	value = GetLocked();
+	return true;
+}
+
+template<class T>
+template<class Rep, class Period>
+inline bool TBlockingQueue<T>::PutFor(const T& value, const std::chrono::duration<Rep, Period>& timeout)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!closed && queue.IsFull()) {
+		++waiting_put;
+		not_full.wait_for(lock, timeout, [this] { return closed || !queue.IsFull(); });
+		--waiting_put;
+	}
+	if (closed || queue.IsFull()) return false;
+	PutLocked(value);
+	return true;
+}
+
+template<class T>
+template<class Rep, class Period>
+inline bool TBlockingQueue<T>::GetFor(T& value, const std::chrono::duration<Rep, Period>& timeout)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!closed && queue.IsEmpty()) {
+		++waiting_get;
+		not_empty.wait_for(lock, timeout, [this] { return closed || !queue.IsEmpty(); });
+		--waiting_get;
+	}
+	if (queue.IsEmpty()) return false;
+	value = GetLocked();
+	return true;
+}
+
+template<class T>
+inline size_t TBlockingQueue<T>::PutBatch(const T* values, size_t count_values)
+{
+	size_t put = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (put < count_values) {
+		if (!closed && queue.IsFull()) {
+			++waiting_put;
+			not_full.wait(lock, [this] { return closed || !queue.IsFull(); });
+			--waiting_put;
+		}
+		if (closed) break;
+
+		bool was_empty = queue.IsEmpty();
+		while (put < count_values && !queue.IsFull()) queue.Put(values[put++]);
+		if (was_empty && waiting_get > 0) not_empty.notify_all();
+	}
+	return put;
+}
+
+template<class T>
+inline size_t TBlockingQueue<T>::GetBatch(T* values, size_t max_count)
+{
+	if (max_count == 0) return 0;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!closed && queue.IsEmpty()) {
+		++waiting_get;
+		not_empty.wait(lock, [this] { return closed || !queue.IsEmpty(); });
+		--waiting_get;
+	}
+
+	bool was_full = queue.IsFull();
+	size_t got = 0;
+	while (got < max_count && !queue.IsEmpty()) values[got++] = queue.Get();
+	if (got > 0 && was_full && waiting_put > 0) not_full.notify_all();
+	if (got > 0 && queue.IsEmpty() && waiting_drain > 0) drained.notify_all();
+	return got;
+}
+
+template<class T>
+inline void TBlockingQueue<T>::Close()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	closed = true;
+	not_empty.notify_all();
+	not_full.notify_all();
+}
+
+template<class T>
+inline void TBlockingQueue<T>::Drain()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (queue.IsEmpty()) return;
+	++waiting_drain;
+	drained.wait(lock, [this] { return queue.IsEmpty(); });
+	--waiting_drain;
+}
@@ -0,0 +1,221 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "TError.hpp"
+#include "TMultiStack.h"
+
+// TMultiStack that many threads can use at once. Every stack has its own spin
+// lock on its own cache line, so Push and Pop on different stacks don't wait for
+// each other. A stack only writes its own [begin, next begin) range and its own
+// top, and begins change only during a repack, so the fast path needs nothing
+// else.
+//
+// A Push that finds its stack full takes the whole multistack exclusively: it
+// locks every stack in order (one repacker at a time through repack_mutex), so
+// the repack sees no Push or Pop in flight. That is the global write lock; the
+// fast path never touches a shared reader count, so threads working on
+// different stacks only meet when a stack overflows. The slack tree of
+// TMultiStack is not kept up to date on the fast path and is rebuilt at the
+// start of every exclusive section, together with the size.
+template<class T>
+class TConcurrentMultiStack : protected TMultiStack<T> {
+protected:
+	using TBase = TMultiStack<T>;
+	static constexpr size_t CACHE_LINE = 64;
+
+	struct alignas(CACHE_LINE) TStackLock {
+		std::atomic<bool> locked;
+
+		TStackLock() : locked(false) {}
+	};
+
+	// The count of stacks never changes; a copy of it can be read without a
+	// lock, unlike the base members a repack rewrites.
+	const size_t count_locks;
+	TStackLock* locks;
+	std::mutex repack_mutex;
+	// Changed while the stack is still locked, so a Pop is counted after the
+	// Push it removes and total never goes below 0.
+	std::atomic<size_t> total;
+	std::atomic<size_t> shared_capacity;
+
+	void Lock(size_t count_of_stack);
+	void Unlock(size_t count_of_stack);
+	void LockAll();
+	void UnlockAll();
+
+	void PushExclusive(size_t count_of_stack, const T& value);
+
+public:
+	TConcurrentMultiStack(size_t count_stacks_, size_t capacity_stack, bool growable_ = false);
+	TConcurrentMultiStack(const TConcurrentMultiStack<T>& other) = delete;
+	TConcurrentMultiStack& operator=(const TConcurrentMultiStack<T>& other) = delete;
+	~TConcurrentMultiStack();
+
+	size_t GetCountStacks() const;
+	size_t GetCapacity_M() const;
+	size_t GetSize_M() const;
+	size_t GetSizeOfStack(size_t count_of_stack);
+	bool IsEmpty(size_t count_of_stack);
+	bool IsEmpty_M() const;
+	bool IsGrowable() const;
+
+	void Push(size_t count_of_stack, const T& value);
+	T Pop(size_t count_of_stack);
+	bool TryPop(size_t count_of_stack, T& value);
+};
+
+template<class T>
+inline TConcurrentMultiStack<T>::TConcurrentMultiStack(size_t count_stacks_, size_t capacity_stack, bool growable_)
+	: TBase(count_stacks_, capacity_stack, growable_), count_locks(count_stacks_), locks(nullptr), total(0),
+	  shared_capacity(this->capacity)
+{
+	if (count_stacks_ == 0) throw TError("Count of stacks can't be 0", __func__, __FILE__, __LINE__);
+	locks = new TStackLock[count_stacks_];
+}
+
+template<class T>
+inline TConcurrentMultiStack<T>::~TConcurrentMultiStack()
+{
+	delete[] locks;
+}
+
+template<class T>
+inline void TConcurrentMultiStack<T>::Lock(size_t count_of_stack)
+{
+	std::atomic<bool>& locked = locks[count_of_stack].locked;
+	while (locked.exchange(true, std::memory_order_acquire)) {
+		while (locked.load(std::memory_order_relaxed)) std::this_thread::yield();
+	}
+}
+
+template<class T>
+inline void TConcurrentMultiStack<T>::Unlock(size_t count_of_stack)
+{
+	locks[count_of_stack].locked.store(false, std::memory_order_release);
+}
+
+template<class T>
+inline void TConcurrentMultiStack<T>::LockAll()
+{
+	repack_mutex.lock();
+	for (size_t i = 0; i < count_locks; ++i) Lock(i);
+}
+
+template<class T>
+inline void TConcurrentMultiStack<T>::UnlockAll()
+{
+	for (size_t i = 0; i < count_locks; ++i) Unlock(i);
+	repack_mutex.unlock();
+}
+
+// Slow path of Push: the stack may have been repacked by another thread while
+// this one waited, so fullness is checked again before repacking. The fast
+// path keeps only total, not the size of the base, so the size the repack
+// relies on is summed from the bounds themselves.
+template<class T>
+inline void TConcurrentMultiStack<T>::PushExclusive(size_t count_of_stack, const T& value)
+{
+	LockAll();
+	try {
+		this->size = 0;
+		for (size_t i = 0; i < this->count_stacks; ++i)
+			this->size += this->stacks[i].top - this->stacks[i].begin;
+		this->BuildSlackTree();
+		TBase::Push(count_of_stack, value);
+	} catch (...) {
+		UnlockAll();
+		throw;
+	}
+	total.fetch_add(1, std::memory_order_relaxed);
+	shared_capacity.store(this->capacity, std::memory_order_relaxed);
+	UnlockAll();
+}
+
+template<class T>
+inline size_t TConcurrentMultiStack<T>::GetCountStacks() const
+{
+	return count_locks;
+}
+
+template<class T>
+inline size_t TConcurrentMultiStack<T>::GetCapacity_M() const
+{
+	return shared_capacity.load(std::memory_order_relaxed);
+}
+
+template<class T>
+inline size_t TConcurrentMultiStack<T>::GetSize_M() const
+{
+	return total.load(std::memory_order_relaxed);
+}
+
+template<class T>
+inline size_t TConcurrentMultiStack<T>::GetSizeOfStack(size_t count_of_stack)
+{
+	if (count_of_stack >= count_locks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+	Lock(count_of_stack);
+	size_t size = this->stacks[count_of_stack].top - this->stacks[count_of_stack].begin;
+	Unlock(count_of_stack);
+	return size;
+}
+
+template<class T>
+inline bool TConcurrentMultiStack<T>::IsEmpty(size_t count_of_stack)
+{
+	return GetSizeOfStack(count_of_stack) == 0;
+}
+
+template<class T>
+inline bool TConcurrentMultiStack<T>::IsEmpty_M() const
+{
+	return GetSize_M() == 0;
+}
+
+template<class T>
+inline bool TConcurrentMultiStack<T>::IsGrowable() const
+{
+	return this->growable;
+}
+
+template<class T>
+inline void TConcurrentMultiStack<T>::Push(size_t count_of_stack, const T& value)
+{
+	if (count_of_stack >= count_locks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+
+	Lock(count_of_stack);
+	if (!TBase::IsFull(count_of_stack)) {
+		this->data[this->stacks[count_of_stack].top++] = value;
+		total.fetch_add(1, std::memory_order_relaxed);
+		Unlock(count_of_stack);
+		return;
+	}
+	Unlock(count_of_stack);
+	PushExclusive(count_of_stack, value);
+}
+
+template<class T>
+inline bool TConcurrentMultiStack<T>::TryPop(size_t count_of_stack, T& value)
+{
+	if (count_of_stack >= count_locks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+
+	Lock(count_of_stack);
+	if (TBase::IsEmpty(count_of_stack)) {
+		Unlock(count_of_stack);
+		return false;
+	}
+	value = std::move(this->data[--this->stacks[count_of_stack].top]);
+	total.fetch_sub(1, std::memory_order_relaxed);
+	Unlock(count_of_stack);
+	return true;
+}
+
+template<class T>
+inline T TConcurrentMultiStack<T>::Pop(size_t count_of_stack)
+{
+	T value;
+	if (!TryPop(count_of_stack, value)) throw TError("Stack is empty", __func__, __FILE__, __LINE__);
+	return value;
+}
@@ -0,0 +1,445 @@
+#pragma once
+#include <iostream>
+#include <initializer_list>
+#include <utility>
+
+#include "TError.hpp"
+
+// Double-ended queue made of fixed-size blocks. The block map holds pointers to
+// the blocks, so pushing at either end never moves elements and element i is
+// found with one division: map[(start + i) / BLOCK_SIZE][(start + i) % BLOCK_SIZE].
+template<class T>
+class TDeque {
+public:
+	static constexpr size_t BLOCK_SIZE = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+
+protected:
+	static constexpr size_t MIN_MAP_SIZE = 8;
+
+	T** map;
+	size_t map_size;
+	size_t start;
+	size_t count;
+
+	T& Element(size_t index);
+	const T& Element(size_t index) const;
+	void GrowMap();
+	void Init();
+	void Free();
+
+public:
+	TDeque();
+	TDeque(std::initializer_list<T> init_list);
+	TDeque(const TDeque<T>& other);
+	TDeque(TDeque<T>&& other) noexcept;
+	~TDeque();
+
+	size_t GetSize() const;
+	bool IsEmpty() const;
+
+	void PushBack(const T& value);
+	void PushFront(const T& value);
+	T PopBack();
+	T PopFront();
+
+	T& Front();
+	const T& Front() const;
+	T& Back();
+	const T& Back() const;
+
+	void Clear();
+
+	TDeque& operator=(const TDeque<T>& other);
+	TDeque& operator=(TDeque<T>&& other) noexcept;
+
+	bool operator==(const TDeque<T>& other) const;
+	bool operator!=(const TDeque<T>& other) const;
+
+	T& operator[](const size_t& index);
+	const T& operator[](const size_t& index) const;
+
+	template<class O>
+	friend std::ostream& operator<<(std::ostream& out, const TDeque<O>& other);
+
+	class TIterator {
+	private:
+		TDeque<T>* deque;
+		size_t index;
+
+	public:
+		TIterator(TDeque<T>* d, size_t idx) : deque(d), index(idx) {}
+
+		T& operator*() {
+			return deque->Element(index);
+		}
+
+		T* operator->() {
+			return &(deque->Element(index));
+		}
+
+		TIterator& operator++() {
+			++index;
+			return *this;
+		}
+
+		TIterator operator++(int) {
+			TIterator temp = *this;
+			++index;
+			return temp;
+		}
+
+		TIterator& operator--() {
+			--index;
+			return *this;
+		}
+
+		TIterator operator--(int) {
+			TIterator temp = *this;
+			--index;
+			return temp;
+		}
+
+		bool operator==(const TIterator& other) const {
+			return deque == other.deque && index == other.index;
+		}
+
+		bool operator!=(const TIterator& other) const {
+			return !(*this == other);
+		}
+	};
+
+	class TConstIterator {
+	private:
+		const TDeque<T>* deque;
+		size_t index;
+
+	public:
+		TConstIterator(const TDeque<T>* d, size_t idx) : deque(d), index(idx) {}
+
+		const T& operator*() const {
+			return deque->Element(index);
+		}
+
+		const T* operator->() const {
+			return &(deque->Element(index));
+		}
+
+		TConstIterator& operator++() {
+			++index;
+			return *this;
+		}
+
+		TConstIterator operator++(int) {
+			TConstIterator temp = *this;
+			++index;
+			return temp;
+		}
+
+		TConstIterator& operator--() {
+			--index;
+			return *this;
+		}
+
+		TConstIterator operator--(int) {
+			TConstIterator temp = *this;
+			--index;
+			return temp;
+		}
+
+		bool operator==(const TConstIterator& other) const {
+			return deque == other.deque && index == other.index;
+		}
+
+		bool operator!=(const TConstIterator& other) const {
+			return !(*this == other);
+		}
+	};
+
+	TIterator begin() noexcept {
+		return TIterator(this, 0);
+	}
+
+	TIterator end() noexcept {
+		return TIterator(this, count);
+	}
+
+	TConstIterator begin() const noexcept {
+		return TConstIterator(this, 0);
+	}
+
+	TConstIterator end() const noexcept {
+		return TConstIterator(this, count);
+	}
+
+	TConstIterator cbegin() const noexcept {
+		return TConstIterator(this, 0);
+	}
+
+	TConstIterator cend() const noexcept {
+		return TConstIterator(this, count);
+	}
+};
+
+template<class T>
+inline T& TDeque<T>::Element(size_t index)
+{
+	size_t position = start + index;
+	return map[position / BLOCK_SIZE][position % BLOCK_SIZE];
+}
+
+template<class T>
+inline const T& TDeque<T>::Element(size_t index) const
+{
+	size_t position = start + index;
+	return map[position / BLOCK_SIZE][position % BLOCK_SIZE];
+}
+
+template<class T>
+inline void TDeque<T>::Init()
+{
+	map_size = MIN_MAP_SIZE;
+	map = new T*[map_size]();
+	start = (map_size / 2) * BLOCK_SIZE;
+}
+
+template<class T>
+inline void TDeque<T>::GrowMap()
+{
+	size_t first_block = start / BLOCK_SIZE;
+	size_t last_block = (start + count) / BLOCK_SIZE;
+	size_t used_blocks = last_block - first_block + 1;
+
+	size_t new_size = map_size;
+	while (new_size < 2 * (used_blocks + 1)) new_size *= 2;
+	size_t new_first = (new_size - used_blocks) / 2;
+
+	T** new_map = new T*[new_size]();
+	for (size_t i = 0; i < used_blocks && first_block + i < map_size; ++i)
+		new_map[new_first + i] = map[first_block + i];
+
+	delete[] map;
+	map = new_map;
+	map_size = new_size;
+	start = new_first * BLOCK_SIZE + start % BLOCK_SIZE;
+}
+
+template<class T>
+inline void TDeque<T>::Free()
+{
+	if (map) {
+		for (size_t i = 0; i < map_size; ++i) delete[] map[i];
+		delete[] map;
+	}
+	map = nullptr;
+	map_size = 0;
+	start = 0;
+	count = 0;
+}
+
+template<class T>
+inline TDeque<T>::TDeque() : map(nullptr), map_size(0), start(0), count(0) {}
+
+template<class T>
+inline TDeque<T>::TDeque(std::initializer_list<T> init_list) : map(nullptr), map_size(0), start(0), count(0)
+{
+	for (const auto& elem : init_list) PushBack(elem);
+}
+
+template<class T>
+inline TDeque<T>::TDeque(const TDeque<T>& other) : map(nullptr), map_size(0), start(0), count(0)
+{
+	for (size_t i = 0; i < other.count; ++i) PushBack(other.Element(i));
+}
+
+template<class T>
+inline TDeque<T>::TDeque(TDeque<T>&& other) noexcept
+	: map(other.map), map_size(other.map_size), start(other.start), count(other.count)
+{
+	other.map = nullptr;
+	other.map_size = 0;
+	other.start = 0;
+	other.count = 0;
+}
+
+template<class T>
+inline TDeque<T>::~TDeque()
+{
+	Free();
+}
+
+template<class T>
+inline size_t TDeque<T>::GetSize() const
+{
+	return count;
+}
+
+template<class T>
+inline bool TDeque<T>::IsEmpty() const
+{
+	return count == 0;
+}
+
+template<class T>
+inline void TDeque<T>::PushBack(const T& value)
+{
+	if (!map) Init();
+	size_t position = start + count;
+	if (position / BLOCK_SIZE >= map_size) {
+		GrowMap();
+		position = start + count;
+	}
+	size_t block = position / BLOCK_SIZE;
+	if (!map[block]) map[block] = new T[BLOCK_SIZE];
+	map[block][position % BLOCK_SIZE] = value;
+	count++;
+}
+
+template<class T>
+inline void TDeque<T>::PushFront(const T& value)
+{
+	if (!map) Init();
+	if (start == 0) GrowMap();
+	size_t block = (start - 1) / BLOCK_SIZE;
+	if (!map[block]) map[block] = new T[BLOCK_SIZE];
+	map[block][(start - 1) % BLOCK_SIZE] = value;
+	start--;
+	count++;
+}
+
+template<class T>
+inline T TDeque<T>::PopBack()
+{
+	if (IsEmpty()) throw TError("Deque is empty", __func__, __FILE__, __LINE__);
+	size_t position = start + count - 1;
+	size_t block = position / BLOCK_SIZE;
+	T value = std::move(map[block][position % BLOCK_SIZE]);
+	count--;
+
+	if (count == 0) start = block * BLOCK_SIZE + BLOCK_SIZE / 2;
+	else if (position % BLOCK_SIZE == 0) {
+		delete[] map[block];
+		map[block] = nullptr;
+	}
+	return value;
+}
+
+template<class T>
+inline T TDeque<T>::PopFront()
+{
+	if (IsEmpty()) throw TError("Deque is empty", __func__, __FILE__, __LINE__);
+	size_t block = start / BLOCK_SIZE;
+	T value = std::move(map[block][start % BLOCK_SIZE]);
+	start++;
+	count--;
+
+	if (count == 0) start = block * BLOCK_SIZE + BLOCK_SIZE / 2;
+	else if (start % BLOCK_SIZE == 0) {
+		delete[] map[block];
+		map[block] = nullptr;
+	}
+	return value;
+}
+
+template<class T>
+inline T& TDeque<T>::Front()
+{
+	if (IsEmpty()) throw TError("Deque is empty", __func__, __FILE__, __LINE__);
+	return Element(0);
+}
+
+template<class T>
+inline const T& TDeque<T>::Front() const
+{
+	if (IsEmpty()) throw TError("Deque is empty", __func__, __FILE__, __LINE__);
+	return Element(0);
+}
+
+template<class T>
+inline T& TDeque<T>::Back()
+{
+	if (IsEmpty()) throw TError("Deque is empty", __func__, __FILE__, __LINE__);
+	return Element(count - 1);
+}
+
+template<class T>
+inline const T& TDeque<T>::Back() const
+{
+	if (IsEmpty()) throw TError("Deque is empty", __func__, __FILE__, __LINE__);
+	return Element(count - 1);
+}
+
+template<class T>
+inline void TDeque<T>::Clear()
+{
+	Free();
+}
+
+template<class T>
+inline TDeque<T>& TDeque<T>::operator=(const TDeque<T>& other)
+{
+	if (this != &other) {
+		TDeque<T> temp(other);
+		*this = std::move(temp);
+	}
+	return *this;
+}
+
+template<class T>
+inline TDeque<T>& TDeque<T>::operator=(TDeque<T>&& other) noexcept
+{
+	if (this != &other) {
+		Free();
+		map = other.map;
+		map_size = other.map_size;
+		start = other.start;
+		count = other.count;
+
+		other.map = nullptr;
+		other.map_size = 0;
+		other.start = 0;
+		other.count = 0;
+	}
+	return *this;
+}
+
+template<class T>
+inline bool TDeque<T>::operator==(const TDeque<T>& other) const
+{
+	if (count != other.count) return false;
+	for (size_t i = 0; i < count; ++i) {
+		if (Element(i) != other.Element(i)) return false;
+	}
+	return true;
+}
+
+template<class T>
+inline bool TDeque<T>::operator!=(const TDeque<T>& other) const
+{
+	return !(*this == other);
+}
+
+template<class T>
+inline T& TDeque<T>::operator[](const size_t& index)
+{
+	if (index >= count) throw TError("Index out of range", __func__, __FILE__, __LINE__);
+	return Element(index);
+}
+
+template<class T>
+inline const T& TDeque<T>::operator[](const size_t& index) const
+{
+	if (index >= count) throw TError("Index out of range", __func__, __FILE__, __LINE__);
+	return Element(index);
+}
+
+template<class O>
+inline std::ostream& operator<<(std::ostream& out, const TDeque<O>& other)
+{
+	out << "{ ";
+	for (size_t i = 0; i < other.count; ++i) {
+		out << other.Element(i);
+		if (i < other.count - 1) out << "; ";
+	}
+	out << " }";
+	return out;
+}
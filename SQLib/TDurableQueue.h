@@ -0,0 +1,236 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+#include "TError.hpp"
+#include "TQueue.h"
+
+// TQueue whose state survives a restart. Every Put/Get is appended to a binary
+// journal (<path>.log) before it is applied; every checkpoint_interval records the
+// whole queue is written to a binary snapshot (<path>.snap) and the journal is
+// started anew. On open the snapshot is loaded and the journal replayed; a torn
+// record at the end of the journal (crash in the middle of a write) is dropped.
+//
+// Snapshot and journal carry a generation number. A journal is replayed only
+// if its generation matches the snapshot, so a crash between writing a new
+// snapshot and resetting the journal can't apply the same records twice.
+// The snapshot also records the capacity; it must be reopened with the same one.
+// Records are flushed to the OS after each operation: a crashed process loses
+// nothing, a crashed machine may lose what the OS has not written back yet.
+template<class T>
+class TDurableQueue {
+	static_assert(std::is_trivially_copyable<T>::value, "TDurableQueue stores elements as raw bytes");
+
+protected:
+	struct TSnapshotHeader {
+		char magic[4];
+		uint32_t element_size;
+		uint64_t generation;
+		uint64_t capacity;
+		uint64_t count;
+	};
+
+	static constexpr char PUT_RECORD = 'P';
+	static constexpr char GET_RECORD = 'G';
+
+	TQueue<T> queue;
+	std::string path;
+	std::ofstream journal;
+	uint64_t generation;
+	size_t journal_records;
+	size_t checkpoint_interval;
+
+	std::string SnapshotName() const;
+	std::string JournalName() const;
+
+	void LoadSnapshot();
+	void ReplayJournal();
+	void StartJournal();
+	void AppendRecord(char type, const T* value);
+
+public:
+	TDurableQueue(const std::string& path_, size_t capacity_, size_t checkpoint_interval_ = 1024);
+	TDurableQueue(const TDurableQueue<T>& other) = delete;
+	TDurableQueue& operator=(const TDurableQueue<T>& other) = delete;
+
+	size_t GetSize() const;
+	size_t GetCapacity() const;
+
+	bool IsEmpty() const;
+	bool IsFull() const;
+
+	void Put(const T& value);
+	T Get();
+
+	void Checkpoint();
+
+	const TQueue<T>& GetQueue() const;
+};
+
+template<class T>
+inline TDurableQueue<T>::TDurableQueue(const std::string& path_, size_t capacity_, size_t checkpoint_interval_)
+	: queue(capacity_), path(path_), generation(0), journal_records(0), checkpoint_interval(checkpoint_interval_)
+{
+	if (capacity_ == 0) throw TError("Capacity can't be 0", __func__, __FILE__, __LINE__);
+	LoadSnapshot();
+	ReplayJournal();
+	Checkpoint();
+}
+
+template<class T>
+inline std::string TDurableQueue<T>::SnapshotName() const
+{
+	return path + ".snap";
+}
+
+template<class T>
+inline std::string TDurableQueue<T>::JournalName() const
+{
+	return path + ".log";
+}
+
+template<class T>
+inline void TDurableQueue<T>::LoadSnapshot()
+{
+	std::ifstream file(SnapshotName(), std::ios::binary);
+	if (!file.is_open()) return;
+
+	TSnapshotHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || std::string(header.magic, 4) != "TQSN" || header.element_size != sizeof(T))
+		throw TError("Incorrect snapshot", __func__, __FILE__, __LINE__);
+	if (header.capacity != queue.GetCapacity())
+		throw TError("Snapshot capacity differs from the queue", __func__, __FILE__, __LINE__);
+	if (header.count > header.capacity)
+		throw TError("Snapshot does not fit into the queue", __func__, __FILE__, __LINE__);
+
+	T value;
+	for (uint64_t i = 0; i < header.count; ++i) {
+		file.read(reinterpret_cast<char*>(&value), sizeof(T));
+		if (!file) throw TError("Incorrect snapshot", __func__, __FILE__, __LINE__);
+		queue.Put(value);
+	}
+	generation = header.generation;
+}
+
+template<class T>
+inline void TDurableQueue<T>::ReplayJournal()
+{
+	std::ifstream file(JournalName(), std::ios::binary);
+	if (!file.is_open()) return;
+
+	uint64_t journal_generation = 0;
+	file.read(reinterpret_cast<char*>(&journal_generation), sizeof(journal_generation));
+	if (!file || journal_generation != generation) return;
+
+	char type;
+	T value;
+	while (file.read(&type, 1)) {
+		if (type == PUT_RECORD) {
+			if (!file.read(reinterpret_cast<char*>(&value), sizeof(T))) break;
+			if (queue.IsFull()) throw TError("Incorrect journal", __func__, __FILE__, __LINE__);
+			queue.Put(value);
+		}
+		else if (type == GET_RECORD) {
+			if (queue.IsEmpty()) throw TError("Incorrect journal", __func__, __FILE__, __LINE__);
+			queue.Get();
+		}
+		else break;
+	}
+}
+
+template<class T>
+inline void TDurableQueue<T>::StartJournal()
+{
+	if (journal.is_open()) journal.close();
+	journal.open(JournalName(), std::ios::binary | std::ios::trunc);
+	if (!journal.is_open()) throw TError("Cannot open file", __func__, __FILE__, __LINE__);
+	journal.write(reinterpret_cast<const char*>(&generation), sizeof(generation));
+	journal.flush();
+	journal_records = 0;
+}
+
+template<class T>
+inline void TDurableQueue<T>::AppendRecord(char type, const T* value)
+{
+	journal.write(&type, 1);
+	if (value) journal.write(reinterpret_cast<const char*>(value), sizeof(T));
+	journal.flush();
+	if (!journal) throw TError("Cannot write journal", __func__, __FILE__, __LINE__);
+	journal_records++;
+}
+
+template<class T>
+inline size_t TDurableQueue<T>::GetSize() const
+{
+	return queue.GetSize();
+}
+
+template<class T>
+inline size_t TDurableQueue<T>::GetCapacity() const
+{
+	return queue.GetCapacity();
+}
+
+template<class T>
+inline bool TDurableQueue<T>::IsEmpty() const
+{
+	return queue.IsEmpty();
+}
+
+template<class T>
+inline bool TDurableQueue<T>::IsFull() const
+{
+	return queue.IsFull();
+}
+
+template<class T>
+inline void TDurableQueue<T>::Put(const T& value)
+{
+	if (queue.IsFull()) throw TError("Queue is full", __func__, __FILE__, __LINE__);
+	AppendRecord(PUT_RECORD, &value);
+	queue.Put(value);
+	if (journal_records >= checkpoint_interval) Checkpoint();
+}
+
+template<class T>
+inline T TDurableQueue<T>::Get()
+{
+	if (queue.IsEmpty()) throw TError("Queue is empty", __func__, __FILE__, __LINE__);
+	AppendRecord(GET_RECORD, nullptr);
+	T value = queue.Get();
+	if (journal_records >= checkpoint_interval) Checkpoint();
+	return value;
+}
+
+template<class T>
+inline void TDurableQueue<T>::Checkpoint()
+{
+	std::string temp_name = SnapshotName() + ".tmp";
+	{
+		std::ofstream file(temp_name, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) throw TError("Cannot open file", __func__, __FILE__, __LINE__);
+
+		TSnapshotHeader header = { { 'T', 'Q', 'S', 'N' }, sizeof(T), generation + 1, queue.GetCapacity(), queue.GetSize() };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		queue.ForEachSpan([&file](const T* first, const T* last) {
+			file.write(reinterpret_cast<const char*>(first), (last - first) * sizeof(T));
+		});
+		file.flush();
+		if (!file) throw TError("Cannot write snapshot", __func__, __FILE__, __LINE__);
+	}
+	if (std::rename(temp_name.c_str(), SnapshotName().c_str()) != 0)
+		throw TError("Cannot replace snapshot", __func__, __FILE__, __LINE__);
+
+	generation++;
+	StartJournal();
+}
+
+template<class T>
+inline const TQueue<T>& TDurableQueue<T>::GetQueue() const
+{
+	return queue;
+}
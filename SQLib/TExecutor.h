@@ -0,0 +1,157 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "TError.hpp"
+#include "TDeque.h"
+
+class TExecutor;
+
+// Detached coroutine started with TExecutor::Spawn. The frame is created
+// suspended, runs only inside TExecutor::Run/RunOne and frees itself when it
+// finishes. An exception escaping the coroutine is rethrown from the Run/RunOne
+// call that resumed it.
+class TAsyncTask {
+public:
+	struct promise_type {
+		TExecutor* executor = nullptr;
+		promise_type* prev = nullptr;
+		promise_type* next = nullptr;
+
+		~promise_type();
+
+		TAsyncTask get_return_object() noexcept;
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept;
+	};
+
+	using THandle = std::coroutine_handle<promise_type>;
+
+protected:
+	THandle handle;
+
+	explicit TAsyncTask(THandle handle_) : handle(handle_) {}
+
+	friend class TExecutor;
+
+public:
+	TAsyncTask(const TAsyncTask& other) = delete;
+	TAsyncTask(TAsyncTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	~TAsyncTask();
+
+	TAsyncTask& operator=(const TAsyncTask& other) = delete;
+	TAsyncTask& operator=(TAsyncTask&& other) = delete;
+};
+
+// Single-threaded executor: a FIFO of coroutines ready to run, resumed one by
+// one on the thread that calls Run. Awaitables such as TAsyncQueue put a
+// suspended coroutine back with Schedule instead of resuming it inline, so a
+// long producer/consumer chain never grows the stack. Tasks still suspended
+// when the executor is destroyed are destroyed with it.
+class TExecutor {
+protected:
+	TDeque<std::coroutine_handle<>> ready;
+	TAsyncTask::promise_type* tasks;
+	size_t count_tasks;
+	std::exception_ptr error;
+
+	friend struct TAsyncTask::promise_type;
+
+public:
+	TExecutor();
+	TExecutor(const TExecutor& other) = delete;
+	TExecutor& operator=(const TExecutor& other) = delete;
+	~TExecutor();
+
+	size_t GetCountTasks() const;
+	size_t GetCountReady() const;
+
+	void Spawn(TAsyncTask task);
+	void Schedule(std::coroutine_handle<> handle);
+
+	bool RunOne();
+	size_t Run();
+};
+
+inline TAsyncTask::promise_type::~promise_type()
+{
+	if (!executor) return;
+	if (prev) prev->next = next;
+	else executor->tasks = next;
+	if (next) next->prev = prev;
+	executor->count_tasks--;
+}
+
+inline TAsyncTask TAsyncTask::promise_type::get_return_object() noexcept
+{
+	return TAsyncTask(THandle::from_promise(*this));
+}
+
+inline void TAsyncTask::promise_type::unhandled_exception() noexcept
+{
+	if (executor && !executor->error) executor->error = std::current_exception();
+}
+
+inline TAsyncTask::~TAsyncTask()
+{
+	if (handle) handle.destroy();
+}
+
+inline TExecutor::TExecutor() : tasks(nullptr), count_tasks(0) {}
+
+inline TExecutor::~TExecutor()
+{
+	while (tasks) TAsyncTask::THandle::from_promise(*tasks).destroy();
+}
+
+inline size_t TExecutor::GetCountTasks() const
+{
+	return count_tasks;
+}
+
+inline size_t TExecutor::GetCountReady() const
+{
+	return ready.GetSize();
+}
+
+inline void TExecutor::Spawn(TAsyncTask task)
+{
+	if (!task.handle) throw TError("Task is empty", __func__, __FILE__, __LINE__);
+	TAsyncTask::promise_type& promise = task.handle.promise();
+	if (promise.executor) throw TError("Task is already spawned", __func__, __FILE__, __LINE__);
+
+	promise.executor = this;
+	promise.next = tasks;
+	if (tasks) tasks->prev = &promise;
+	tasks = &promise;
+	count_tasks++;
+
+	ready.PushBack(std::exchange(task.handle, nullptr));
+}
+
+inline void TExecutor::Schedule(std::coroutine_handle<> handle)
+{
+	ready.PushBack(handle);
+}
+
+inline bool TExecutor::RunOne()
+{
+	if (ready.IsEmpty()) return false;
+	ready.PopFront().resume();
+
+	if (error) {
+		std::exception_ptr first = std::exchange(error, nullptr);
+		std::rethrow_exception(first);
+	}
+	return true;
+}
+
+inline size_t TExecutor::Run()
+{
+	size_t resumed = 0;
+	while (RunOne()) resumed++;
+	return resumed;
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TError.hpp"
+#include "TMultiStack.h"
+
+// TMultiStack whose block (begins, tops and data) is a shared mapping of a file
+// behind a small header. Opening an existing file maps it and checks the
+// header and the stack bounds, which costs O(count of stacks) however many
+// elements it holds; the OS pages the data in on first touch. Every Push and Pop
+// goes straight to the mapping, and Sync() makes it durable with msync.
+//
+// The file has a fixed capacity: a full stack is served by repacking in place,
+// and there is no growth and no AddStack/RemoveStack, which would need a new
+// block.
+template<class T>
+class TMappedMultiStack : protected TMultiStack<T> {
+	static_assert(std::is_trivially_copyable<T>::value, "TMappedMultiStack stores elements as raw bytes");
+
+protected:
+	using TBase = TMultiStack<T>;
+
+	struct THeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t endian;
+		uint32_t element_size;
+		uint64_t capacity;
+		uint64_t count_stacks;
+	};
+
+	static constexpr uint32_t VERSION = 1;
+
+	std::string path;
+	char* mapping;
+	size_t mapped_size;
+
+	static size_t HeaderSize();
+	static size_t FileSize(size_t count, size_t slots);
+	void Map(int fd, size_t size);
+	void Unmap();
+
+public:
+	TMappedMultiStack(const std::string& path_, size_t count_stacks_, size_t capacity_stack);
+	TMappedMultiStack(const std::string& path_);
+	TMappedMultiStack(const TMappedMultiStack<T>& other) = delete;
+	~TMappedMultiStack();
+
+	TMappedMultiStack& operator=(const TMappedMultiStack<T>& other) = delete;
+
+	using TBase::GetCapacity_M;
+	using TBase::GetSize_M;
+	using TBase::GetCountStacks;
+	using TBase::GetSizeOfStack;
+	using TBase::IsFull;
+	using TBase::IsEmpty;
+	using TBase::IsFull_M;
+	using TBase::IsEmpty_M;
+	using TBase::Push;
+	using TBase::Pop;
+	using TBase::FindMin;
+	using TBase::SaveToFile;
+	using TBase::operator();
+
+	void Sync();
+	void Unlink();
+};
+
+template<class T>
+inline size_t TMappedMultiStack<T>::HeaderSize()
+{
+	return (sizeof(THeader) + TBase::ALIGN - 1) / TBase::ALIGN * TBase::ALIGN;
+}
+
+template<class T>
+inline size_t TMappedMultiStack<T>::FileSize(size_t count, size_t slots)
+{
+	return HeaderSize() + TBase::DataOffset(count) + slots * sizeof(T);
+}
+
+template<class T>
+inline void TMappedMultiStack<T>::Map(int fd, size_t size)
+{
+	void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (memory == MAP_FAILED) throw TError("Cannot map file", __func__, __FILE__, __LINE__);
+
+	mapping = static_cast<char*>(memory);
+	mapped_size = size;
+}
+
+// The base destructor must not free a block it did not allocate.
+template<class T>
+inline void TMappedMultiStack<T>::Unmap()
+{
+	this->Attach(nullptr, 0, 0);
+	this->size = 0;
+	if (mapping) munmap(mapping, mapped_size);
+	mapping = nullptr;
+	mapped_size = 0;
+}
+
+template<class T>
+inline TMappedMultiStack<T>::TMappedMultiStack(const std::string& path_, size_t count_stacks_, size_t capacity_stack)
+	: TBase(), path(path_), mapping(nullptr), mapped_size(0)
+{
+	if (count_stacks_ == 0) throw TError("Count of stacks can't be 0", __func__, __FILE__, __LINE__);
+
+	int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0) throw TError("Cannot open file", __func__, __FILE__, __LINE__);
+
+	size_t capacity_ = count_stacks_ * capacity_stack;
+	size_t file_size = FileSize(count_stacks_, capacity_);
+	if (ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+		close(fd);
+		throw TError("Cannot resize file", __func__, __FILE__, __LINE__);
+	}
+	Map(fd, file_size);
+
+	THeader* header = reinterpret_cast<THeader*>(mapping);
+	std::memcpy(header->magic, "TMSM", 4);
+	header->version = VERSION;
+	header->endian = BYTE_ORDER_MARK;
+	header->element_size = sizeof(T);
+	header->capacity = capacity_;
+	header->count_stacks = count_stacks_;
+
+	this->Attach(mapping + HeaderSize(), count_stacks_, capacity_);
+	for (size_t i = 0; i < count_stacks_; ++i) {
+		this->stacks[i].begin = i * capacity_stack;
+		this->stacks[i].top = i * capacity_stack;
+		this->old_top_stacks[i] = i * capacity_stack;
+	}
+	this->BuildSlackTree();
+}
+
+template<class T>
+inline TMappedMultiStack<T>::TMappedMultiStack(const std::string& path_)
+	: TBase(), path(path_), mapping(nullptr), mapped_size(0)
+{
+	int fd = open(path.c_str(), O_RDWR);
+	if (fd < 0) throw TError("Cannot open file", __func__, __FILE__, __LINE__);
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < HeaderSize()) {
+		close(fd);
+		throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+	}
+	Map(fd, static_cast<size_t>(info.st_size));
+
+	const THeader* header = reinterpret_cast<const THeader*>(mapping);
+	uint64_t count = header->count_stacks;
+	uint64_t slots = header->capacity;
+	uint64_t room = mapped_size - HeaderSize();
+	if (std::memcmp(header->magic, "TMSM", 4) != 0 || header->version != VERSION || header->endian != BYTE_ORDER_MARK
+		|| header->element_size != sizeof(T) || count == 0 || count > room / TBase::ControlSize(1)
+		|| slots > room / sizeof(T) || mapped_size != FileSize(count, slots)) {
+		Unmap();
+		throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+	}
+	this->Attach(mapping + HeaderSize(), count, slots);
+
+	// The bounds in the file are trusted only after the same checks the file
+	// constructor of TMultiStack does; size, the growth history and the slack
+	// tree are rebuilt.
+	for (size_t i = 0; i < this->count_stacks; ++i) {
+		size_t limit = i + 1 < this->count_stacks ? this->stacks[i + 1].begin : this->capacity;
+		if (this->stacks[i].begin > this->stacks[i].top || this->stacks[i].top > limit) {
+			Unmap();
+			throw TError("Incorrect stack bounds", __func__, __FILE__, __LINE__);
+		}
+		this->old_top_stacks[i] = this->stacks[i].top;
+		this->size += this->stacks[i].top - this->stacks[i].begin;
+	}
+	this->BuildSlackTree();
+}
+
+template<class T>
+inline TMappedMultiStack<T>::~TMappedMultiStack()
+{
+	Unmap();
+}
+
+// Blocks until everything written through the mapping is on disk.
+template<class T>
+inline void TMappedMultiStack<T>::Sync()
+{
+	if (msync(mapping, mapped_size, MS_SYNC) != 0) throw TError("Cannot sync file", __func__, __FILE__, __LINE__);
+}
+
+template<class T>
+inline void TMappedMultiStack<T>::Unlink()
+{
+	unlink(path.c_str());
+}
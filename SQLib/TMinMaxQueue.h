@@ -0,0 +1,123 @@
+#pragma once
+#include <iostream>
+
+#include "TError.hpp"
+#include "TDeque.h"
+
+// FIFO queue with O(1) amortized FindMin/FindMax. Besides the elements it keeps
+// two monotonic deques of element numbers: candidates for the minimum (values
+// non-decreasing from front to back) and for the maximum (non-increasing).
+// With a non-zero window the queue holds the last `window` elements: Put on a
+// full queue drops the oldest one.
+template<class T>
+class TMinMaxQueue {
+protected:
+	TDeque<T> items;
+	TDeque<size_t> min_candidates;
+	TDeque<size_t> max_candidates;
+	size_t first;
+	size_t window;
+
+	const T& ByNumber(size_t number) const;
+
+public:
+	TMinMaxQueue();
+	TMinMaxQueue(size_t window_);
+
+	size_t GetSize() const;
+	size_t GetWindow() const;
+
+	bool IsEmpty() const;
+	bool IsFull() const;
+
+	void Put(const T& value);
+	T Get();
+
+	const T& FindMin() const;
+	const T& FindMax() const;
+
+	template<class O>
+	friend std::ostream& operator<<(std::ostream& out, const TMinMaxQueue<O>& other);
+};
+
+template<class T>
+inline TMinMaxQueue<T>::TMinMaxQueue() : first(0), window(0) {}
+
+template<class T>
+inline TMinMaxQueue<T>::TMinMaxQueue(size_t window_) : first(0), window(window_) {}
+
+template<class T>
+inline const T& TMinMaxQueue<T>::ByNumber(size_t number) const
+{
+	return items[number - first];
+}
+
+template<class T>
+inline size_t TMinMaxQueue<T>::GetSize() const
+{
+	return items.GetSize();
+}
+
+template<class T>
+inline size_t TMinMaxQueue<T>::GetWindow() const
+{
+	return window;
+}
+
+template<class T>
+inline bool TMinMaxQueue<T>::IsEmpty() const
+{
+	return items.IsEmpty();
+}
+
+template<class T>
+inline bool TMinMaxQueue<T>::IsFull() const
+{
+	return window != 0 && items.GetSize() == window;
+}
+
+template<class T>
+inline void TMinMaxQueue<T>::Put(const T& value)
+{
+	if (IsFull()) Get();
+
+	size_t number = first + items.GetSize();
+	items.PushBack(value);
+
+	while (!min_candidates.IsEmpty() && value < ByNumber(min_candidates.Back())) min_candidates.PopBack();
+	min_candidates.PushBack(number);
+
+	while (!max_candidates.IsEmpty() && ByNumber(max_candidates.Back()) < value) max_candidates.PopBack();
+	max_candidates.PushBack(number);
+}
+
+template<class T>
+inline T TMinMaxQueue<T>::Get()
+{
+	if (IsEmpty()) throw TError("Queue is empty", __func__, __FILE__, __LINE__);
+
+	if (min_candidates.Front() == first) min_candidates.PopFront();
+	if (max_candidates.Front() == first) max_candidates.PopFront();
+	first++;
+	return items.PopFront();
+}
+
+template<class T>
+inline const T& TMinMaxQueue<T>::FindMin() const
+{
+	if (IsEmpty()) throw TError("Queue is empty", __func__, __FILE__, __LINE__);
+	return ByNumber(min_candidates.Front());
+}
+
+template<class T>
+inline const T& TMinMaxQueue<T>::FindMax() const
+{
+	if (IsEmpty()) throw TError("Queue is empty", __func__, __FILE__, __LINE__);
+	return ByNumber(max_candidates.Front());
+}
+
+template<class O>
+inline std::ostream& operator<<(std::ostream& out, const TMinMaxQueue<O>& other)
+{
+	return out << other.items;
+}
@@ -3,23 +3,99 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <string>
 #include "TError.hpp"
+#include "TBinaryIO.h"
 
 template<typename T>
 class TMultiStack
 {
 protected:
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr size_t ALIGN = alignof(T) > CACHE_LINE ? alignof(T) : CACHE_LINE;
+
+    // begin and top of a stack side by side: IsFull(i) reads stacks[i].top and
+    // stacks[i + 1].begin, which are adjacent, and Push/Pop touch one pair.
+    struct TBounds {
+        size_t begin;
+        size_t top;
+    };
+
+    // File layout (SaveToFile): the header, then count_stacks begins and
+    // count_stacks tops as uint64_t, then the capacity data slots. With
+    // FILE_COMPACT set, the header is followed by count_stacks stack sizes and
+    // only the elements of every stack in turn. Numbers are in the byte order
+    // of the writer, given by endian; checksum is FNV-1a of the whole file,
+    // taken with the checksum field set to 0.
+    struct TFileHeader {
+        char magic[4];
+        uint16_t version;
+        uint16_t flags;
+        uint32_t endian;
+        uint32_t element_size;
+        uint64_t capacity;
+        uint64_t count_stacks;
+        uint64_t checksum;
+    };
+    static_assert(sizeof(TFileHeader) == 40, "TFileHeader must have no padding");
+
+    static constexpr uint16_t FILE_VERSION = 1;
+    static constexpr uint16_t FILE_COMPACT = 1;
+
+    // Most elements a borrow may shift per slot it gains (see PaysToBorrow).
+    static constexpr size_t BORROW_COST = 4;
+
     size_t capacity;
     size_t count_stacks;
-
+    size_t size;
+    bool growable;
+
+    // One cache-aligned block: count_stacks TBounds pairs, old tops, slack_tree,
+    // then capacity data slots aligned to ALIGN.
+    char* memory;
+    TBounds* stacks;
+    size_t* old_top_stacks;
+    size_t* slack_tree;
     T* data;
-    size_t* begin_stacks;
-    size_t* top_stacks;
-    
+
+    static size_t ControlSize(size_t count);
+    static size_t DataOffset(size_t count);
+    static char* Allocate(size_t count, size_t slots);
+    static void Release(char* block, size_t count, size_t slots);
+    void Attach(char* block, size_t count, size_t slots);
+
+    static TFileHeader ReadHeader(std::istream& file, bool& swap, uint64_t& header_hash);
+    static void CheckCompactBody(std::istream& file, const TFileHeader& header, bool swap, uint64_t header_hash,
+        uint64_t data_size);
+    void ReadBounds(TBinaryReader& reader);
+    void ReadSizes(TBinaryReader& reader, uint64_t max_size);
+    void ReadSlots(TBinaryReader& reader, size_t first, size_t last);
+    void WriteSlots(TBinaryWriter& writer, size_t first, size_t last) const;
+
+    void BuildSlackTree();
+    void MarkSlack(size_t count_of_stack, bool has_slack);
+    size_t CountSlack(size_t end) const;
+    size_t FindSlack(size_t rank) const;
+    size_t GetSlack(size_t count_of_stack) const;
+
+    static size_t Share(size_t part, size_t whole, size_t amount);
+    size_t BorrowAmount(size_t lender) const;
+    bool PaysToBorrow(size_t lender, size_t moved) const;
+    void Borrow(size_t count_of_stack, size_t lender);
+    size_t* PlanLayout(size_t count_of_stack, size_t new_capacity) const;
+    void ApplyLayout(size_t count_of_stack, const size_t* new_begin);
+    void MoveStacks(const size_t* new_begin, size_t new_capacity);
+    void Rebuild(size_t new_count, size_t new_capacity, const size_t* moved_begin, const size_t* new_begin, const size_t* new_top);
+    void Redistribute(size_t count_of_stack);
+    void Grow(size_t count_of_stack);
     void Repack(size_t count_of_stack);
 public:
     TMultiStack();
-    TMultiStack(size_t count_stacks_, size_t capacity_stack);
+    TMultiStack(size_t count_stacks_, size_t capacity_stack, bool growable_ = false);
     TMultiStack(const TMultiStack& other);
     TMultiStack(TMultiStack&& other) noexcept;
     TMultiStack(const std::string& filename);
@@ -29,7 +105,7 @@ public:
     bool operator!=(const TMultiStack& other) const;
 
     T operator()(size_t count_of_stack, size_t index) const;
-    
+
     TMultiStack& operator=(const TMultiStack& other);
     TMultiStack& operator=(TMultiStack&& other) noexcept;
 
@@ -37,6 +113,7 @@ public:
     size_t GetSize_M() const;
     size_t GetCountStacks() const;
     size_t GetSizeOfStack(size_t count_of_stack) const;
+    bool IsGrowable() const;
 
     bool IsFull(size_t count_of_stack) const;
     bool IsEmpty(size_t count_of_stack) const;
@@ -47,130 +124,572 @@ public:
     void Push(size_t count_of_stack, const T& value);
     T Pop(size_t count_of_stack);
 
+    void AddStack(size_t count_of_stack, size_t capacity_stack = 0);
+    void RemoveStack(size_t count_of_stack);
+
     T FindMin() const;
-    void SaveToFile(const std::string& filename) const;
+    void SaveToFile(const std::string& filename, bool compact = false) const;
 
     template<class O>
     friend std::ostream& operator<<(std::ostream& out, const TMultiStack<O>& stack);
 };
 
 template<typename T>
-inline void TMultiStack<T>::Repack(size_t count_of_stack)
+inline size_t TMultiStack<T>::ControlSize(size_t count)
 {
-    if (count_of_stack >= count_stacks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
-    if (IsFull_M()) throw TError("Mutlistack is full", __func__, __FILE__, __LINE__);
-    size_t find_first_nofull = 0;
+    return count * (sizeof(TBounds) + 2 * sizeof(size_t));
+}
+
+template<typename T>
+inline size_t TMultiStack<T>::DataOffset(size_t count)
+{
+    return (ControlSize(count) + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+// Allocates the block for count stacks and slots elements; the slots are
+// default-constructed like new T[] would.
+template<typename T>
+inline char* TMultiStack<T>::Allocate(size_t count, size_t slots)
+{
+    if (count == 0 && slots == 0) return nullptr;
+
+    const size_t max_bytes = std::numeric_limits<size_t>::max() - ALIGN;
+    if (count > max_bytes / ControlSize(1) || slots > (max_bytes - ControlSize(count)) / sizeof(T))
+        throw TError("MultiStack is too large", __func__, __FILE__, __LINE__);
+
+    size_t bytes = DataOffset(count) + slots * sizeof(T);
+    char* block = nullptr;
+    try {
+        block = static_cast<char*>(::operator new(bytes, std::align_val_t(ALIGN)));
+    } catch (const std::bad_alloc&) {
+        throw TError("Cannot allocate memory", __func__, __FILE__, __LINE__);
+    }
+    T* first = reinterpret_cast<T*>(block + DataOffset(count));
+    size_t built = 0;
+    try {
+        for (; built < slots; ++built) new (first + built) T();
+    } catch (...) {
+        while (built > 0) first[--built].~T();
+        ::operator delete(block, std::align_val_t(ALIGN));
+        throw;
+    }
+    return block;
+}
+
+template<typename T>
+inline void TMultiStack<T>::Release(char* block, size_t count, size_t slots)
+{
+    if (!block) return;
+    T* first = reinterpret_cast<T*>(block + DataOffset(count));
+    for (size_t i = 0; i < slots; ++i) first[i].~T();
+    ::operator delete(block, std::align_val_t(ALIGN));
+}
+
+template<typename T>
+inline void TMultiStack<T>::Attach(char* block, size_t count, size_t slots)
+{
+    memory = block;
+    count_stacks = count;
+    capacity = slots;
+    stacks = count > 0 ? reinterpret_cast<TBounds*>(block) : nullptr;
+    old_top_stacks = count > 0 ? reinterpret_cast<size_t*>(stacks + count) : nullptr;
+    slack_tree = count > 0 ? old_top_stacks + count : nullptr;
+    data = slots > 0 ? reinterpret_cast<T*>(block + DataOffset(count)) : nullptr;
+}
+
+// Reads and checks the file header; swap is set when the file was written with
+// the other byte order, header_hash is where the checksum of the body starts.
+template<typename T>
+inline typename TMultiStack<T>::TFileHeader TMultiStack<T>::ReadHeader(std::istream& file, bool& swap,
+    uint64_t& header_hash)
+{
+    TFileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, "TMSK", 4) != 0)
+        throw TError("Incorrect file", __func__, __FILE__, __LINE__);
+
+    TFileHeader unsigned_header = header;
+    unsigned_header.checksum = 0;
+    header_hash = Fnv1a(&unsigned_header, sizeof(unsigned_header));
+
+    swap = header.endian != BYTE_ORDER_MARK;
+    if (swap) {
+        if (ByteSwap(header.endian) != BYTE_ORDER_MARK) throw TError("Incorrect file", __func__, __FILE__, __LINE__);
+        header.version = ByteSwap(header.version);
+        header.flags = ByteSwap(header.flags);
+        header.element_size = ByteSwap(header.element_size);
+        header.capacity = ByteSwap(header.capacity);
+        header.count_stacks = ByteSwap(header.count_stacks);
+        header.checksum = ByteSwap(header.checksum);
+    }
+
+    if (header.version != FILE_VERSION) throw TError("Unsupported file version", __func__, __FILE__, __LINE__);
+    if ((header.flags & ~FILE_COMPACT) != 0) throw TError("Unsupported file flags", __func__, __FILE__, __LINE__);
+    if (header.element_size != sizeof(T)) throw TError("Incorrect element size", __func__, __FILE__, __LINE__);
+    return header;
+}
+
+// A compact file does not bound its capacity by its size, so before anything
+// is allocated its body is checked: the stack sizes against the capacity and
+// the elements that follow, then the checksum. data_size is the size of the
+// body after the stack sizes. The stream is left at the start of the body.
+template<typename T>
+inline void TMultiStack<T>::CheckCompactBody(std::istream& file, const TFileHeader& header, bool swap,
+    uint64_t header_hash, uint64_t data_size)
+{
+    std::streamoff begin_of_body = file.tellg();
+    TBinaryReader reader(file, swap, header_hash);
+    uint64_t live = 0;
+    for (uint64_t i = 0; i < header.count_stacks; ++i) {
+        uint64_t size_of_stack = reader.ReadValue<uint64_t>();
+        if (size_of_stack > header.capacity - live)
+            throw TError("Incorrect stack bounds", __func__, __FILE__, __LINE__);
+        live += size_of_stack;
+    }
+    if (TElementIO<T>::BULK && (data_size % sizeof(T) != 0 || data_size / sizeof(T) != live))
+        throw TError("Incorrect file", __func__, __FILE__, __LINE__);
+
+    char chunk[4096];
+    while (data_size > 0) {
+        size_t part = data_size < sizeof(chunk) ? static_cast<size_t>(data_size) : sizeof(chunk);
+        reader.Read(chunk, part);
+        data_size -= part;
+    }
+    if (reader.GetChecksum() != header.checksum)
+        throw TError("Checksum mismatch", __func__, __FILE__, __LINE__);
+    file.seekg(begin_of_body);
+}
+
+// Reads begins and tops into the attached block and checks that every stack
+// lies within [begin, next begin) and the last one within capacity.
+template<typename T>
+inline void TMultiStack<T>::ReadBounds(TBinaryReader& reader)
+{
+    for (size_t i = 0; i < count_stacks; ++i)
+        stacks[i].begin = static_cast<size_t>(reader.ReadValue<uint64_t>());
+    for (size_t i = 0; i < count_stacks; ++i)
+        stacks[i].top = static_cast<size_t>(reader.ReadValue<uint64_t>());
+
+    size = 0;
     for (size_t i = 0; i < count_stacks; ++i) {
-        if (!this->IsFull(i)) {
-            find_first_nofull = i;
-            break;
+        size_t limit = i + 1 < count_stacks ? stacks[i + 1].begin : capacity;
+        if (stacks[i].begin > stacks[i].top || stacks[i].top > limit)
+            throw TError("Incorrect stack bounds", __func__, __FILE__, __LINE__);
+        old_top_stacks[i] = stacks[i].top;
+        size += stacks[i].top - stacks[i].begin;
+    }
+    BuildSlackTree();
+}
+
+// Reads the stack sizes of a compact file and lays the stacks out with the
+// free slots split evenly between them, like RemoveStack does.
+template<typename T>
+inline void TMultiStack<T>::ReadSizes(TBinaryReader& reader, uint64_t max_size)
+{
+    size = 0;
+    for (size_t i = 0; i < count_stacks; ++i) {
+        uint64_t size_of_stack = reader.ReadValue<uint64_t>();
+        if (size_of_stack > capacity - size || size_of_stack > max_size - size)
+            throw TError("Incorrect stack bounds", __func__, __FILE__, __LINE__);
+        stacks[i].top = static_cast<size_t>(size_of_stack);
+        size += stacks[i].top;
+    }
+
+    size_t free_space = capacity - size;
+    size_t cursor = 0;
+    for (size_t i = 0; i < count_stacks; ++i) {
+        stacks[i].begin = cursor;
+        stacks[i].top += cursor;
+        old_top_stacks[i] = stacks[i].top;
+        cursor = stacks[i].top + Share(i + 1, count_stacks, free_space) - Share(i, count_stacks, free_space);
+    }
+    BuildSlackTree();
+}
+
+template<typename T>
+inline void TMultiStack<T>::ReadSlots(TBinaryReader& reader, size_t first, size_t last)
+{
+    if constexpr (TElementIO<T>::BULK) {
+        reader.Read(data + first, (last - first) * sizeof(T));
+        if (reader.IsSwapped()) TElementIO<T>::FromOtherOrder(data + first, last - first);
+    } else {
+        for (size_t k = first; k < last; ++k)
+            TElementIO<T>::Read(reader, data[k]);
+    }
+}
+
+template<typename T>
+inline void TMultiStack<T>::WriteSlots(TBinaryWriter& writer, size_t first, size_t last) const
+{
+    if constexpr (TElementIO<T>::BULK) {
+        writer.Write(data + first, (last - first) * sizeof(T));
+    } else {
+        for (size_t k = first; k < last; ++k)
+            TElementIO<T>::Write(writer, data[k]);
+    }
+}
+
+// slack_tree is a Fenwick tree over per-stack flags "has free slots": a stack
+// counts as 1 while top < begin of the next stack. Push and Pop touch it only
+// when a stack becomes full or stops being full.
+template<typename T>
+inline void TMultiStack<T>::BuildSlackTree()
+{
+    for (size_t i = 0; i < count_stacks; ++i) slack_tree[i] = GetSlack(i) > 0 ? 1 : 0;
+    for (size_t k = 1; k <= count_stacks; ++k) {
+        size_t parent = k + (k & (~k + 1));
+        if (parent <= count_stacks) slack_tree[parent - 1] += slack_tree[k - 1];
+    }
+}
+
+template<typename T>
+inline void TMultiStack<T>::MarkSlack(size_t count_of_stack, bool has_slack)
+{
+    for (size_t k = count_of_stack + 1; k <= count_stacks; k += k & (~k + 1)) {
+        if (has_slack) slack_tree[k - 1]++;
+        else slack_tree[k - 1]--;
+    }
+}
+
+// Number of stacks with free slots among stacks [0, end).
+template<typename T>
+inline size_t TMultiStack<T>::CountSlack(size_t end) const
+{
+    size_t count = 0;
+    for (size_t k = end; k > 0; k &= k - 1) count += slack_tree[k - 1];
+    return count;
+}
+
+// Index of the rank-th (from 1) stack with free slots.
+template<typename T>
+inline size_t TMultiStack<T>::FindSlack(size_t rank) const
+{
+    size_t step = 1;
+    while (step * 2 <= count_stacks) step *= 2;
+
+    size_t k = 0;
+    for (; step > 0; step /= 2) {
+        if (k + step <= count_stacks && slack_tree[k + step - 1] < rank) {
+            k += step;
+            rank -= slack_tree[k - 1];
         }
     }
+    return k;
+}
+
+template<typename T>
+inline size_t TMultiStack<T>::GetSlack(size_t count_of_stack) const
+{
+    size_t end = count_of_stack + 1 < count_stacks ? stacks[count_of_stack + 1].begin : capacity;
+    return end - stacks[count_of_stack].top;
+}
+
+// floor(amount * part / whole), exact for part == whole, so consecutive
+// differences of Share over a running total add up to amount.
+template<typename T>
+inline size_t TMultiStack<T>::Share(size_t part, size_t whole, size_t amount)
+{
+    if (whole == 0 || part >= whole) return amount;
+    size_t share = static_cast<size_t>(static_cast<long double>(amount) * part / whole);
+    return share < amount ? share : amount;
+}
+
+// Half of the free slots of lender, at least one.
+template<typename T>
+inline size_t TMultiStack<T>::BorrowAmount(size_t lender) const
+{
+    return (GetSlack(lender) + 1) / 2;
+}
+
+// Whether borrowing from lender is worth shifting moved elements: it is if the
+// shift costs at most BORROW_COST moves per slot gained, or no more than
+// BORROW_COST stacks of average capacity hold. Either way the cost of a borrow
+// does not grow with the size of any one stack, as a fixed share of the
+// multistack would.
+template<typename T>
+inline bool TMultiStack<T>::PaysToBorrow(size_t lender, size_t moved) const
+{
+    return moved <= BORROW_COST * std::max(BorrowAmount(lender), capacity / count_stacks);
+}
 
-    if (find_first_nofull < count_of_stack) {
-        for (size_t i = begin_stacks[find_first_nofull + 1]; i < top_stacks[count_of_stack]; ++i)
-            data[i - 1] = std::move(data[i]);
-        for (size_t i = find_first_nofull + 1; i <= count_of_stack; ++i) {
-            --begin_stacks[i];
-            --top_stacks[i];
+// Moves BorrowAmount(lender) free slots to the full stack count_of_stack by
+// shifting only the stacks between them.
+template<typename T>
+inline void TMultiStack<T>::Borrow(size_t count_of_stack, size_t lender)
+{
+    size_t slack = GetSlack(lender);
+    size_t amount = BorrowAmount(lender);
+
+    if (lender < count_of_stack) {
+        for (size_t k = stacks[lender + 1].begin; k < stacks[count_of_stack].top; ++k) data[k - amount] = std::move(data[k]);
+        for (size_t i = lender + 1; i <= count_of_stack; ++i) {
+            stacks[i].begin -= amount;
+            stacks[i].top -= amount;
+            old_top_stacks[i] -= amount;
         }
     } else {
-        for (size_t i = top_stacks[find_first_nofull] - 1; i >= begin_stacks[count_of_stack + 1]; --i)
-            data[i + 1] = std::move(data[i]);
-        
-        for (size_t i = count_of_stack + 1; i <= find_first_nofull; ++i) {
-            ++begin_stacks[i];
-            ++top_stacks[i];
+        for (size_t k = stacks[lender].top; k > stacks[count_of_stack + 1].begin; --k) data[k - 1 + amount] = std::move(data[k - 1]);
+        for (size_t i = count_of_stack + 1; i <= lender; ++i) {
+            stacks[i].begin += amount;
+            stacks[i].top += amount;
+            old_top_stacks[i] += amount;
         }
     }
+
+    MarkSlack(count_of_stack, true);
+    if (amount == slack) MarkSlack(lender, false);
 }
 
+// Garwick's reallocation (Knuth, TAOCP 2.2.2, algorithm G): returns the new
+// begins of the stacks in a buffer of new_capacity slots. The free space left
+// after the pending push is split anew: 10% equally between the stacks, 90% in
+// proportion to how much each stack has grown since the previous reallocation,
+// so a stack that keeps overflowing gets most of the room.
 template<typename T>
-inline TMultiStack<T>::TMultiStack() : capacity(0), count_stacks(0), data(nullptr), begin_stacks(nullptr), top_stacks(nullptr) {}
+inline size_t* TMultiStack<T>::PlanLayout(size_t count_of_stack, size_t new_capacity) const
+{
+    size_t total_growth = 1;
+    for (size_t i = 0; i < count_stacks; ++i) {
+        if (stacks[i].top > old_top_stacks[i]) total_growth += stacks[i].top - old_top_stacks[i];
+    }
+    size_t free_space = new_capacity - size - 1;
+    size_t equal_space = free_space / 10;
+    size_t growth_space = free_space - equal_space;
+
+    size_t* new_begin = new size_t[count_stacks];
+    new_begin[0] = 0;
+    size_t growth = 0;
+    size_t given = 0;
+    for (size_t i = 0; i + 1 < count_stacks; ++i) {
+        size_t length = stacks[i].top - stacks[i].begin + (i == count_of_stack ? 1 : 0);
+        if (stacks[i].top > old_top_stacks[i]) growth += stacks[i].top - old_top_stacks[i];
+        if (i == count_of_stack) growth += 1;
+
+        size_t total = Share(i + 1, count_stacks, equal_space) + Share(growth, total_growth, growth_space);
+        new_begin[i + 1] = new_begin[i] + length + (total - given);
+        given = total;
+    }
+    return new_begin;
+}
 
 template<typename T>
-inline TMultiStack<T>::TMultiStack(size_t count_stacks_, size_t capacity_stack)
-    : capacity(count_stacks_ * capacity_stack), count_stacks(count_stacks_)
+inline void TMultiStack<T>::ApplyLayout(size_t count_of_stack, const size_t* new_begin)
 {
-    if (capacity == 0 || count_stacks == 0) {
-        data = nullptr;
-        begin_stacks = nullptr;
-        top_stacks = nullptr;
-    } else {
-        data = new T[capacity];
-        begin_stacks = new size_t[count_stacks];
-        top_stacks = new size_t[count_stacks];
-        
+    for (size_t i = 0; i < count_stacks; ++i) {
+        stacks[i].top = new_begin[i] + (stacks[i].top - stacks[i].begin);
+        stacks[i].begin = new_begin[i];
+        old_top_stacks[i] = stacks[i].top + (i == count_of_stack ? 1 : 0);
+    }
+    BuildSlackTree();
+}
+
+// Puts every stack at new_begin[i] in a buffer of new_capacity slots, moving
+// each element once. In place this is Knuth's algorithm R: stacks that move
+// down are moved in increasing order, stacks that move up in decreasing order,
+// so nothing is overwritten before it has been moved. A new capacity means a new
+// block; the control part is copied and elements are moved straight into their
+// slots. The begins and tops are left for the caller to update.
+template<typename T>
+inline void TMultiStack<T>::MoveStacks(const size_t* new_begin, size_t new_capacity)
+{
+    if (new_capacity != capacity) {
+        char* block = Allocate(count_stacks, new_capacity);
+        std::memcpy(block, memory, ControlSize(count_stacks));
+        T* new_data = reinterpret_cast<T*>(block + DataOffset(count_stacks));
         for (size_t i = 0; i < count_stacks; ++i) {
-            begin_stacks[i] = i * capacity_stack;
-            top_stacks[i] = i * capacity_stack;
+            for (size_t k = stacks[i].begin; k < stacks[i].top; ++k)
+                new_data[new_begin[i] + (k - stacks[i].begin)] = std::move(data[k]);
+        }
+        Release(memory, count_stacks, capacity);
+        Attach(block, count_stacks, new_capacity);
+        return;
+    }
+
+    for (size_t i = 0; i < count_stacks; ++i) {
+        if (new_begin[i] < stacks[i].begin) {
+            size_t shift = stacks[i].begin - new_begin[i];
+            for (size_t k = stacks[i].begin; k < stacks[i].top; ++k) data[k - shift] = std::move(data[k]);
+        }
+    }
+    for (size_t i = count_stacks; i-- > 0;) {
+        if (new_begin[i] > stacks[i].begin) {
+            size_t shift = new_begin[i] - stacks[i].begin;
+            for (size_t k = stacks[i].top; k > stacks[i].begin; --k) data[k - 1 + shift] = std::move(data[k - 1]);
         }
     }
 }
 
+// Moves every current stack i to moved_begin[i] in a new block of new_count
+// stacks and new_capacity slots, then sets the stacks to new_begin / new_top
+// and starts the growth history afresh.
 template<typename T>
-inline TMultiStack<T>::TMultiStack(const TMultiStack& other)
-    : capacity(other.capacity), count_stacks(other.count_stacks)
+inline void TMultiStack<T>::Rebuild(size_t new_count, size_t new_capacity, const size_t* moved_begin,
+    const size_t* new_begin, const size_t* new_top)
 {
-    if (capacity > 0) {
-        data = new T[capacity];
-        for (size_t i = 0; i < capacity; ++i)
-            data[i] = other.data[i];
-    } else {
-        data = nullptr;
+    char* block = Allocate(new_count, new_capacity);
+    T* new_data = reinterpret_cast<T*>(block + DataOffset(new_count));
+    for (size_t i = 0; i < count_stacks; ++i) {
+        for (size_t k = stacks[i].begin; k < stacks[i].top; ++k)
+            new_data[moved_begin[i] + (k - stacks[i].begin)] = std::move(data[k]);
     }
+    Release(memory, count_stacks, capacity);
+    Attach(block, new_count, new_capacity);
 
-    if (count_stacks > 0) {
-        begin_stacks = new size_t[count_stacks];
-        top_stacks = new size_t[count_stacks];
-        for (size_t i = 0; i < count_stacks; ++i) {
-            begin_stacks[i] = other.begin_stacks[i];
-            top_stacks[i] = other.top_stacks[i];
+    for (size_t i = 0; i < count_stacks; ++i) {
+        stacks[i].begin = new_begin[i];
+        stacks[i].top = new_top[i];
+        old_top_stacks[i] = new_top[i];
+    }
+    BuildSlackTree();
+}
+
+template<typename T>
+inline void TMultiStack<T>::Redistribute(size_t count_of_stack)
+{
+    size_t* new_begin = PlanLayout(count_of_stack, capacity);
+    MoveStacks(new_begin, capacity);
+    ApplyLayout(count_of_stack, new_begin);
+    delete[] new_begin;
+}
+
+// Doubles the buffer of a full growable multistack. The new layout is planned
+// like Redistribute over the new capacity.
+template<typename T>
+inline void TMultiStack<T>::Grow(size_t count_of_stack)
+{
+    size_t new_capacity = capacity > 0 ? 2 * capacity : count_stacks;
+    size_t* new_begin = PlanLayout(count_of_stack, new_capacity);
+    MoveStacks(new_begin, new_capacity);
+    ApplyLayout(count_of_stack, new_begin);
+    delete[] new_begin;
+}
+
+// Makes room for one more element in the full stack count_of_stack. The nearest
+// stacks with free slots on both sides are found in O(log k) through slack_tree;
+// the cheaper one to shift lends slots if PaysToBorrow, so a run of borrows
+// costs O(1) per push however large the stacks have grown. Otherwise all free
+// space is redistributed, which gives the growing stack most of it. A full multistack
+// throws, or doubles its buffer if it was created growable.
+template<typename T>
+inline void TMultiStack<T>::Repack(size_t count_of_stack)
+{
+    if (count_of_stack >= count_stacks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+    if (IsFull_M()) {
+        if (!growable) throw TError("Mutlistack is full", __func__, __FILE__, __LINE__);
+        Grow(count_of_stack);
+        return;
+    }
+
+    size_t before = CountSlack(count_of_stack);
+    size_t lender = count_stacks;
+    size_t moved = 0;
+
+    if (before > 0) {
+        size_t left = FindSlack(before);
+        size_t moved_left = stacks[count_of_stack].top - stacks[left + 1].begin;
+        if (PaysToBorrow(left, moved_left)) {
+            lender = left;
+            moved = moved_left;
+        }
+    }
+    if (before < CountSlack(count_stacks)) {
+        size_t right = FindSlack(before + 1);
+        size_t moved_right = stacks[right].top - stacks[count_of_stack + 1].begin;
+        if (PaysToBorrow(right, moved_right) && (lender == count_stacks || moved_right < moved)) {
+            lender = right;
+            moved = moved_right;
         }
-    } else {
-        begin_stacks = nullptr;
-        top_stacks = nullptr;
     }
+
+    if (lender < count_stacks) Borrow(count_of_stack, lender);
+    else Redistribute(count_of_stack);
+}
+
+template<typename T>
+inline TMultiStack<T>::TMultiStack()
+    : capacity(0), count_stacks(0), size(0), growable(false),
+      memory(nullptr), stacks(nullptr), old_top_stacks(nullptr), slack_tree(nullptr), data(nullptr) {}
+
+template<typename T>
+inline TMultiStack<T>::TMultiStack(size_t count_stacks_, size_t capacity_stack, bool growable_)
+    : size(0), growable(growable_)
+{
+    Attach(Allocate(count_stacks_, count_stacks_ * capacity_stack), count_stacks_, count_stacks_ * capacity_stack);
+    for (size_t i = 0; i < count_stacks; ++i) {
+        stacks[i].begin = i * capacity_stack;
+        stacks[i].top = i * capacity_stack;
+        old_top_stacks[i] = i * capacity_stack;
+    }
+    BuildSlackTree();
+}
+
+template<typename T>
+inline TMultiStack<T>::TMultiStack(const TMultiStack& other)
+    : size(other.size), growable(other.growable)
+{
+    Attach(Allocate(other.count_stacks, other.capacity), other.count_stacks, other.capacity);
+    if (count_stacks > 0) std::memcpy(memory, other.memory, ControlSize(count_stacks));
+    for (size_t i = 0; i < capacity; ++i)
+        data[i] = other.data[i];
 }
 
 template<typename T>
 inline TMultiStack<T>::TMultiStack(TMultiStack&& other) noexcept
-    : capacity(other.capacity), count_stacks(other.count_stacks),
-      data(other.data), begin_stacks(other.begin_stacks), top_stacks(other.top_stacks)
+    : capacity(other.capacity), count_stacks(other.count_stacks), size(other.size), growable(other.growable),
+      memory(other.memory), stacks(other.stacks), old_top_stacks(other.old_top_stacks), slack_tree(other.slack_tree),
+      data(other.data)
 {
-    other.capacity = 0;
-    other.count_stacks = 0;
-    other.data = nullptr;
-    other.begin_stacks = nullptr;
-    other.top_stacks = nullptr;
+    other.Attach(nullptr, 0, 0);
+    other.size = 0;
 }
 
 template<class T>
-TMultiStack<T>::TMultiStack(const std::string& filename) : data(nullptr), begin_stacks(nullptr), top_stacks(nullptr), capacity(0), count_stacks(0)
+TMultiStack<T>::TMultiStack(const std::string& filename) : size(0), growable(false)
 {
+    Attach(nullptr, 0, 0);
     std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) throw TError("Cannot open file", __func__, __FILE__, __LINE__);
 
+    bool swap = false;
+    uint64_t header_hash = 0;
+    TFileHeader header = ReadHeader(file, swap, header_hash);
+    bool compact = (header.flags & FILE_COMPACT) != 0;
+
+    // The sizes in the header must match what is left of the file before
+    // anything is allocated for them. A compact file stores only the elements,
+    // so there its capacity is not bounded by the file size and the whole body
+    // is checked first.
+    std::streamoff begin_of_body = file.tellg();
+    file.seekg(0, std::ios::end);
+    uint64_t body = static_cast<uint64_t>(file.tellg() - begin_of_body);
+    file.seekg(begin_of_body);
+    uint64_t bounds_size = (compact ? 1 : 2) * sizeof(uint64_t);
+    if (header.count_stacks > body / bounds_size)
+        throw TError("Incorrect file", __func__, __FILE__, __LINE__);
+    body -= header.count_stacks * bounds_size;
+    uint64_t max_size = TElementIO<T>::BULK ? body / sizeof(T) : body / sizeof(uint64_t);
+    if (!compact && header.capacity > max_size)
+        throw TError("Incorrect file", __func__, __FILE__, __LINE__);
+    if (compact) CheckCompactBody(file, header, swap, header_hash, body);
+
+    Attach(Allocate(header.count_stacks, header.capacity), header.count_stacks, header.capacity);
     try {
-        file.read(reinterpret_cast<char*>(&capacity), sizeof(capacity));
-        file.read(reinterpret_cast<char*>(&count_stacks), sizeof(count_stacks));
-
-        if (capacity > 0) {
-            data = new T[capacity];
-            file.read(reinterpret_cast<char*>(data), capacity * sizeof(T));
-        }
-
-        if (count_stacks > 0) {
-            begin_stacks = new size_t[count_stacks];
-            top_stacks = new size_t[count_stacks];
-            file.read(reinterpret_cast<char*>(begin_stacks), count_stacks * sizeof(size_t));
-            file.read(reinterpret_cast<char*>(top_stacks), count_stacks * sizeof(size_t));
+        TBinaryReader reader(file, swap, header_hash);
+        if (compact) {
+            ReadSizes(reader, max_size);
+            for (size_t i = 0; i < count_stacks; ++i)
+                ReadSlots(reader, stacks[i].begin, stacks[i].top);
+        } else {
+            ReadBounds(reader);
+            ReadSlots(reader, 0, capacity);
         }
+        if (file.peek() != std::ifstream::traits_type::eof())
+            throw TError("Incorrect file", __func__, __FILE__, __LINE__);
+        if (reader.GetChecksum() != header.checksum)
+            throw TError("Checksum mismatch", __func__, __FILE__, __LINE__);
     } catch (...) {
-        if (data) delete[] data;
-        if (begin_stacks) delete[] begin_stacks;
-        if (top_stacks) delete[] top_stacks;
-        throw TError("Incorrect input", __func__, __FILE__, __LINE__);;
+        Release(memory, count_stacks, capacity);
+        throw;
     }
 
     file.close();
@@ -179,10 +698,7 @@ TMultiStack<T>::TMultiStack(const std::string& filename) : data(nullptr), begin_
 template<typename T>
 inline TMultiStack<T>::~TMultiStack()
 {
-    if (data) delete[] data;
-    if (begin_stacks) delete[] begin_stacks;
-    if (top_stacks) delete[] top_stacks;
-    
+    Release(memory, count_stacks, capacity);
 }
 
 template<typename T>
@@ -190,12 +706,12 @@ inline bool TMultiStack<T>::operator==(const TMultiStack& other) const
 {
     if (count_stacks != other.count_stacks || capacity != other.capacity)
         return false;
-        
+
     for (size_t i = 0; i < count_stacks; ++i) {
-        if (begin_stacks[i] != other.begin_stacks[i] || top_stacks[i] != other.top_stacks[i])
+        if (stacks[i].begin != other.stacks[i].begin || stacks[i].top != other.stacks[i].top)
             return false;
-            
-        for (size_t j = begin_stacks[i]; j < top_stacks[i]; ++j) {
+
+        for (size_t j = stacks[i].begin; j < stacks[i].top; ++j) {
             if (data[j] != other.data[j])
                 return false;
         }
@@ -214,7 +730,7 @@ inline T TMultiStack<T>::operator()(size_t number_of_stacks, size_t index) const
 {
     if (number_of_stacks >= count_stacks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
     if (index >= this->GetSizeOfStack(number_of_stacks)) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
-    return data[begin_stacks[number_of_stacks] + index];
+    return data[stacks[number_of_stacks].begin + index];
 }
 
 template<class T>
@@ -231,21 +747,20 @@ template<class T>
 inline TMultiStack<T>& TMultiStack<T>::operator=(TMultiStack<T>&& other) noexcept
 {
     if (this != &other) {
-        delete[] data;
-        delete[] begin_stacks;
-        delete[] top_stacks;
+        Release(memory, count_stacks, capacity);
 
+        memory = other.memory;
+        stacks = other.stacks;
+        old_top_stacks = other.old_top_stacks;
+        slack_tree = other.slack_tree;
         data = other.data;
-        begin_stacks = other.begin_stacks;
-        top_stacks = other.top_stacks;
         capacity = other.capacity;
         count_stacks = other.count_stacks;
+        size = other.size;
+        growable = other.growable;
 
-        other.data = nullptr;
-        other.begin_stacks = nullptr;
-        other.top_stacks = nullptr;
-        other.capacity = 0;
-        other.count_stacks = 0;
+        other.Attach(nullptr, 0, 0);
+        other.size = 0;
     }
     return *this;
 }
@@ -259,8 +774,6 @@ inline size_t TMultiStack<T>::GetCapacity_M() const
 template <typename T>
 inline size_t TMultiStack<T>::GetSize_M() const
 {
-    size_t size = 0;
-    for (size_t i = 0; i < count_stacks; i++) size += GetSizeOfStack(i);
     return size;
 }
 
@@ -274,25 +787,31 @@ template<class T>
 inline size_t TMultiStack<T>::GetSizeOfStack(size_t number_of_stack) const
 {
     if (number_of_stack >= count_stacks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
-    return top_stacks[number_of_stack] - begin_stacks[number_of_stack];
+    return stacks[number_of_stack].top - stacks[number_of_stack].begin;
+}
+
+template<class T>
+inline bool TMultiStack<T>::IsGrowable() const
+{
+    return growable;
 }
 
 template<class T>
 inline bool TMultiStack<T>::IsFull(size_t number_of_stack) const
 {
     if (number_of_stack >= count_stacks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
-    
+
     if (number_of_stack == count_stacks - 1)
-        return top_stacks[number_of_stack] == capacity;
+        return stacks[number_of_stack].top == capacity;
     else
-        return top_stacks[number_of_stack] == begin_stacks[number_of_stack + 1];
+        return stacks[number_of_stack].top == stacks[number_of_stack + 1].begin;
 }
 
 template<class T>
 inline bool TMultiStack<T>::IsEmpty(size_t number_of_stack) const
 {
     if (number_of_stack >= count_stacks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
-    return top_stacks[number_of_stack] == begin_stacks[number_of_stack];
+    return stacks[number_of_stack].top == stacks[number_of_stack].begin;
 }
 
 template <typename T>
@@ -311,8 +830,10 @@ template<class T>
 inline void TMultiStack<T>::Push(size_t number_of_stack, const T& value)
 {
     if (number_of_stack >= count_stacks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
-    if (this->IsFull(number_of_stack)) this->Repack(number_of_stack); 
-    data[top_stacks[number_of_stack]++] = value;
+    if (this->IsFull(number_of_stack)) this->Repack(number_of_stack);
+    data[stacks[number_of_stack].top++] = value;
+    size++;
+    if (this->IsFull(number_of_stack)) MarkSlack(number_of_stack, false);
 }
 
 template<class T>
@@ -320,8 +841,86 @@ inline T TMultiStack<T>::Pop(size_t number_of_stack)
 {
     if (number_of_stack >= count_stacks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
     if (this->IsEmpty(number_of_stack)) throw TError("Stact is empty", __func__, __FILE__, __LINE__);
-    
-    return data[--top_stacks[number_of_stack]];
+
+    if (this->IsFull(number_of_stack)) MarkSlack(number_of_stack, true);
+    size--;
+    return data[--stacks[number_of_stack].top];
+}
+
+// Inserts an empty stack at position number_of_stack with room for at least
+// capacity_stack elements; the stacks from that position on are renumbered up.
+// A growable multistack doubles its buffer until the room fits. The free space
+// left over is split evenly between all stacks and every stack is laid out
+// again in one pass.
+template<class T>
+inline void TMultiStack<T>::AddStack(size_t number_of_stack, size_t capacity_stack)
+{
+    if (number_of_stack > count_stacks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+
+    size_t new_capacity = capacity;
+    if (capacity - size < capacity_stack) {
+        if (!growable) throw TError("Mutlistack is full", __func__, __FILE__, __LINE__);
+        while (new_capacity - size < capacity_stack) new_capacity = new_capacity > 0 ? 2 * new_capacity : capacity_stack;
+    }
+
+    size_t new_count = count_stacks + 1;
+    size_t free_space = new_capacity - size - capacity_stack;
+    size_t* new_begin = new size_t[new_count];
+    size_t* new_top = new size_t[new_count];
+    size_t* moved_begin = new size_t[new_count];
+
+    size_t cursor = 0;
+    for (size_t j = 0; j < new_count; ++j) {
+        size_t length = 0;
+        size_t room = 0;
+        if (j == number_of_stack) room = capacity_stack;
+        else {
+            size_t i = j < number_of_stack ? j : j - 1;
+            length = stacks[i].top - stacks[i].begin;
+            moved_begin[i] = cursor;
+        }
+        new_begin[j] = cursor;
+        new_top[j] = cursor + length;
+        cursor = new_top[j] + room + Share(j + 1, new_count, free_space) - Share(j, new_count, free_space);
+    }
+
+    Rebuild(new_count, new_capacity, moved_begin, new_begin, new_top);
+    delete[] moved_begin;
+    delete[] new_begin;
+    delete[] new_top;
+}
+
+// Removes the stack number_of_stack with its elements; the stacks after it are
+// renumbered down. Its slots and the rest of the free space are split evenly
+// between the remaining stacks, laid out again in one pass.
+template<class T>
+inline void TMultiStack<T>::RemoveStack(size_t number_of_stack)
+{
+    if (number_of_stack >= count_stacks) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+
+    size -= stacks[number_of_stack].top - stacks[number_of_stack].begin;
+    stacks[number_of_stack].top = stacks[number_of_stack].begin;
+
+    size_t new_count = count_stacks - 1;
+    size_t free_space = capacity - size;
+    size_t* new_begin = new size_t[new_count];
+    size_t* new_top = new size_t[new_count];
+    size_t* moved_begin = new size_t[count_stacks];
+    moved_begin[number_of_stack] = 0;
+
+    size_t cursor = 0;
+    for (size_t j = 0; j < new_count; ++j) {
+        size_t i = j < number_of_stack ? j : j + 1;
+        new_begin[j] = cursor;
+        new_top[j] = cursor + (stacks[i].top - stacks[i].begin);
+        moved_begin[i] = cursor;
+        cursor = new_top[j] + Share(j + 1, new_count, free_space) - Share(j, new_count, free_space);
+    }
+
+    Rebuild(new_count, capacity, moved_begin, new_begin, new_top);
+    delete[] moved_begin;
+    delete[] new_begin;
+    delete[] new_top;
 }
 
 template<class O>
@@ -349,7 +948,7 @@ template<class T>
 inline T TMultiStack<T>::FindMin() const
 {
     if (IsEmpty_M())  throw TError("Stack is empty", __func__, __FILE__, __LINE__);
-    
+
     size_t firstNonEmpty = count_stacks;
     for (size_t i = 0; i < count_stacks; ++i) {
         if (!IsEmpty(i)) {
@@ -357,12 +956,12 @@ inline T TMultiStack<T>::FindMin() const
             break;
         }
     }
-    
-    T minElem = data[begin_stacks[firstNonEmpty]];
-    
+
+    T minElem = data[stacks[firstNonEmpty].begin];
+
     for (size_t i = 0; i < count_stacks; ++i) {
         if (!IsEmpty(i)) {
-            for (size_t j = begin_stacks[i]; j < top_stacks[i]; ++j) {
+            for (size_t j = stacks[i].begin; j < stacks[i].top; ++j) {
                 if (data[j] < minElem)
                     minElem = data[j];
             }
@@ -371,29 +970,44 @@ inline T TMultiStack<T>::FindMin() const
     return minElem;
 }
 
+// A compact file holds only the elements of the stacks, not the free slots
+// between them; loading it gives the same stacks with the free slots split
+// evenly.
 template<class T>
-inline void TMultiStack<T>::SaveToFile(const std::string& filename) const
+inline void TMultiStack<T>::SaveToFile(const std::string& filename, bool compact) const
 {
     std::ofstream file(filename, std::ios::binary);
     if (!file.is_open()) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
-        
-    file.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
-    file.write(reinterpret_cast<const char*>(&count_stacks), sizeof(count_stacks));
-    
-    if (capacity > 0) {
-        for (size_t i = 0; i < capacity; ++i) {
-            file.write(reinterpret_cast<const char*>(&data[i]), sizeof(T));
-        }
-    }
-    
-    if (count_stacks > 0) {
-        for (size_t i = 0; i < count_stacks; ++i) {
-            file.write(reinterpret_cast<const char*>(&begin_stacks[i]), sizeof(size_t));
-        }
-        for (size_t i = 0; i < count_stacks; ++i) {
-            file.write(reinterpret_cast<const char*>(&top_stacks[i]), sizeof(size_t));
-        }
+
+    TFileHeader header = {};
+    std::memcpy(header.magic, "TMSK", 4);
+    header.version = FILE_VERSION;
+    header.flags = compact ? FILE_COMPACT : 0;
+    header.endian = BYTE_ORDER_MARK;
+    header.element_size = sizeof(T);
+    header.capacity = capacity;
+    header.count_stacks = count_stacks;
+
+    // The checksum is known only after the body, so the header is written
+    // again at the end.
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    TBinaryWriter writer(file, Fnv1a(&header, sizeof(header)));
+    if (compact) {
+        for (size_t i = 0; i < count_stacks; ++i)
+            writer.WriteValue<uint64_t>(stacks[i].top - stacks[i].begin);
+        for (size_t i = 0; i < count_stacks; ++i)
+            WriteSlots(writer, stacks[i].begin, stacks[i].top);
+    } else {
+        for (size_t i = 0; i < count_stacks; ++i)
+            writer.WriteValue<uint64_t>(stacks[i].begin);
+        for (size_t i = 0; i < count_stacks; ++i)
+            writer.WriteValue<uint64_t>(stacks[i].top);
+        WriteSlots(writer, 0, capacity);
     }
 
+    header.checksum = writer.GetChecksum();
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
     file.close();
+    if (!file) throw TError("Cannot write file", __func__, __FILE__, __LINE__);
 }
\ No newline at end of file
@@ -0,0 +1,368 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <ostream>
+
+// Instrumentation policies for TQueue and TStack (second template parameter).
+// The container takes a stamp with Stats::Start() before an operation, reports
+// it with OnPut/OnGet together with the size after the operation, and calls
+// OnFull/OnEmpty when it rejects a Put/Get. TNoStats is the default: its hooks
+// are empty and the member is [[no_unique_address]], so an uninstrumented
+// container has the same size and code as before.
+struct TNoStats {
+	using TStamp = int;
+
+	static TStamp Start() noexcept { return 0; }
+	void OnPut(TStamp, size_t) noexcept {}
+	void OnGet(TStamp, size_t) noexcept {}
+	void OnFull() noexcept {}
+	void OnEmpty() noexcept {}
+};
+
+// Starts the statistics of a container over. A policy need not be copyable or
+// assignable (TOpStats holds atomics), so it is rebuilt in place; containers
+// call this when they take on other contents, as a copy starts with fresh Stats.
+template<class Stats>
+inline void ResetStats(Stats& stats)
+{
+	stats.~Stats();
+	new (&stats) Stats();
+}
+
+// Log-linear histogram in the HdrHistogram layout: values below SUB_COUNT get a
+// bucket each, every further power of two is split into SUB_COUNT equal buckets,
+// so a value is reported with a relative error of at most 1 / SUB_COUNT.
+// Record is a few relaxed atomic operations and may be called from any thread.
+class THistogram {
+public:
+	static constexpr unsigned SUB_BITS = 4;
+	static constexpr size_t SUB_COUNT = size_t(1) << SUB_BITS;
+	static constexpr size_t BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+protected:
+	std::atomic<uint64_t> buckets[BUCKET_COUNT];
+	std::atomic<uint64_t> count;
+	std::atomic<uint64_t> sum;
+	std::atomic<uint64_t> min;
+	std::atomic<uint64_t> max;
+
+	static unsigned Log2(uint64_t value);
+
+public:
+	THistogram();
+	THistogram(const THistogram& other) = delete;
+	THistogram& operator=(const THistogram& other) = delete;
+
+	static size_t BucketIndex(uint64_t value);
+	static uint64_t LowerBound(size_t index);
+	static uint64_t UpperBound(size_t index);
+
+	void Record(uint64_t value);
+
+	uint64_t GetCount() const;
+	uint64_t GetBucket(size_t index) const;
+	uint64_t GetMin() const;
+	uint64_t GetMax() const;
+	double GetMean() const;
+	uint64_t Percentile(double percent) const;
+
+	void DumpJSON(std::ostream& out) const;
+};
+
+inline THistogram::THistogram() : count(0), sum(0), min(UINT64_MAX), max(0)
+{
+	for (size_t i = 0; i < BUCKET_COUNT; ++i) buckets[i].store(0, std::memory_order_relaxed);
+}
+
+inline unsigned THistogram::Log2(uint64_t value)
+{
+	unsigned result = 0;
+	for (unsigned shift = 32; shift > 0; shift /= 2) {
+		if (value >> shift) {
+			value >>= shift;
+			result += shift;
+		}
+	}
+	return result;
+}
+
+inline size_t THistogram::BucketIndex(uint64_t value)
+{
+	if (value < SUB_COUNT) return static_cast<size_t>(value);
+	unsigned shift = Log2(value) - SUB_BITS;
+	return (shift + 1) * SUB_COUNT + static_cast<size_t>((value >> shift) - SUB_COUNT);
+}
+
+inline uint64_t THistogram::LowerBound(size_t index)
+{
+	if (index < SUB_COUNT) return index;
+	size_t shift = index / SUB_COUNT - 1;
+	return static_cast<uint64_t>(SUB_COUNT + index % SUB_COUNT) << shift;
+}
+
+inline uint64_t THistogram::UpperBound(size_t index)
+{
+	if (index < SUB_COUNT) return index;
+	size_t shift = index / SUB_COUNT - 1;
+	return LowerBound(index) + ((uint64_t(1) << shift) - 1);
+}
+
+inline void THistogram::Record(uint64_t value)
+{
+	buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	count.fetch_add(1, std::memory_order_relaxed);
+	sum.fetch_add(value, std::memory_order_relaxed);
+
+	uint64_t seen = min.load(std::memory_order_relaxed);
+	while (value < seen && !min.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+	seen = max.load(std::memory_order_relaxed);
+	while (value > seen && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+inline uint64_t THistogram::GetCount() const
+{
+	return count.load(std::memory_order_relaxed);
+}
+
+inline uint64_t THistogram::GetBucket(size_t index) const
+{
+	return index < BUCKET_COUNT ? buckets[index].load(std::memory_order_relaxed) : 0;
+}
+
+inline uint64_t THistogram::GetMin() const
+{
+	return GetCount() ? min.load(std::memory_order_relaxed) : 0;
+}
+
+inline uint64_t THistogram::GetMax() const
+{
+	return max.load(std::memory_order_relaxed);
+}
+
+inline double THistogram::GetMean() const
+{
+	uint64_t total = GetCount();
+	return total ? static_cast<double>(sum.load(std::memory_order_relaxed)) / total : 0.0;
+}
+
+// Upper bound of the bucket holding the value at the given percentile, clamped
+// to the largest value recorded.
+inline uint64_t THistogram::Percentile(double percent) const
+{
+	uint64_t total = GetCount();
+	if (total == 0) return 0;
+
+	uint64_t rank = static_cast<uint64_t>(percent / 100.0 * total + 0.5);
+	if (rank == 0) rank = 1;
+	if (rank > total) rank = total;
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+		seen += buckets[i].load(std::memory_order_relaxed);
+		if (seen >= rank) {
+			uint64_t bound = UpperBound(i);
+			return bound < GetMax() ? bound : GetMax();
+		}
+	}
+	return GetMax();
+}
+
+inline void THistogram::DumpJSON(std::ostream& out) const
+{
+	out << "{\"count\":" << GetCount() << ",\"min\":" << GetMin() << ",\"max\":" << GetMax()
+		<< ",\"mean\":" << GetMean() << ",\"p50\":" << Percentile(50) << ",\"p90\":" << Percentile(90)
+		<< ",\"p99\":" << Percentile(99) << ",\"p999\":" << Percentile(99.9) << ",\"buckets\":[";
+	bool first = true;
+	for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+		uint64_t value = buckets[i].load(std::memory_order_relaxed);
+		if (value == 0) continue;
+		if (!first) out << ",";
+		out << "[" << LowerBound(i) << "," << value << "]";
+		first = false;
+	}
+	out << "]}";
+}
+
+// Statistics policy that records Put/Get latency in nanoseconds, the size after
+// every operation, the high-water mark, rejected operations and a ring of the
+// last SAMPLE_COUNT (time, size) samples taken at most once per sample_interval.
+// All counters are atomics updated with relaxed operations, so another thread can
+// call DumpJSON while the container is in use; the dump is then approximate.
+class TOpStats {
+public:
+	using TClock = std::chrono::steady_clock;
+	using TStamp = TClock::time_point;
+
+	static constexpr size_t SAMPLE_COUNT = 256;
+
+protected:
+	struct TSample {
+		std::atomic<uint64_t> time;
+		std::atomic<uint64_t> size;
+	};
+
+	THistogram put_latency;
+	THistogram get_latency;
+	THistogram occupancy;
+
+	std::atomic<uint64_t> puts;
+	std::atomic<uint64_t> gets;
+	std::atomic<uint64_t> full_rejections;
+	std::atomic<uint64_t> empty_rejections;
+	std::atomic<uint64_t> high_water;
+
+	TStamp created;
+	uint64_t sample_interval;
+	std::atomic<uint64_t> next_sample;
+	std::atomic<uint64_t> samples_taken;
+	TSample samples[SAMPLE_COUNT];
+
+	void Sample(TStamp now, size_t size);
+
+public:
+	TOpStats(std::chrono::nanoseconds sample_interval_ = std::chrono::milliseconds(1));
+	TOpStats(const TOpStats& other) = delete;
+	TOpStats& operator=(const TOpStats& other) = delete;
+
+	static TStamp Start() noexcept { return TClock::now(); }
+	void OnPut(TStamp start, size_t size);
+	void OnGet(TStamp start, size_t size);
+	void OnFull();
+	void OnEmpty();
+
+	uint64_t GetPuts() const;
+	uint64_t GetGets() const;
+	uint64_t GetFullRejections() const;
+	uint64_t GetEmptyRejections() const;
+	uint64_t GetHighWater() const;
+	size_t GetSampleCount() const;
+
+	const THistogram& GetPutLatency() const;
+	const THistogram& GetGetLatency() const;
+	const THistogram& GetOccupancy() const;
+
+	void DumpJSON(std::ostream& out) const;
+};
+
+inline TOpStats::TOpStats(std::chrono::nanoseconds sample_interval_)
+	: puts(0), gets(0), full_rejections(0), empty_rejections(0), high_water(0), created(TClock::now()),
+	  sample_interval(static_cast<uint64_t>(sample_interval_.count())), next_sample(0), samples_taken(0)
+{
+	for (size_t i = 0; i < SAMPLE_COUNT; ++i) {
+		samples[i].time.store(0, std::memory_order_relaxed);
+		samples[i].size.store(0, std::memory_order_relaxed);
+	}
+}
+
+inline void TOpStats::Sample(TStamp now, size_t size)
+{
+	occupancy.Record(size);
+
+	uint64_t seen = high_water.load(std::memory_order_relaxed);
+	while (size > seen && !high_water.compare_exchange_weak(seen, size, std::memory_order_relaxed)) {}
+
+	uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - created).count());
+	uint64_t due = next_sample.load(std::memory_order_relaxed);
+	if (elapsed < due) return;
+	if (!next_sample.compare_exchange_strong(due, elapsed + sample_interval, std::memory_order_relaxed)) return;
+
+	TSample& sample = samples[samples_taken.fetch_add(1, std::memory_order_relaxed) % SAMPLE_COUNT];
+	sample.time.store(elapsed, std::memory_order_relaxed);
+	sample.size.store(size, std::memory_order_relaxed);
+}
+
+inline void TOpStats::OnPut(TStamp start, size_t size)
+{
+	TStamp now = TClock::now();
+	put_latency.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count()));
+	puts.fetch_add(1, std::memory_order_relaxed);
+	Sample(now, size);
+}
+
+inline void TOpStats::OnGet(TStamp start, size_t size)
+{
+	TStamp now = TClock::now();
+	get_latency.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count()));
+	gets.fetch_add(1, std::memory_order_relaxed);
+	Sample(now, size);
+}
+
+inline void TOpStats::OnFull()
+{
+	full_rejections.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void TOpStats::OnEmpty()
+{
+	empty_rejections.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline uint64_t TOpStats::GetPuts() const
+{
+	return puts.load(std::memory_order_relaxed);
+}
+
+inline uint64_t TOpStats::GetGets() const
+{
+	return gets.load(std::memory_order_relaxed);
+}
+
+inline uint64_t TOpStats::GetFullRejections() const
+{
+	return full_rejections.load(std::memory_order_relaxed);
+}
+
+inline uint64_t TOpStats::GetEmptyRejections() const
+{
+	return empty_rejections.load(std::memory_order_relaxed);
+}
+
+inline uint64_t TOpStats::GetHighWater() const
+{
+	return high_water.load(std::memory_order_relaxed);
+}
+
+inline size_t TOpStats::GetSampleCount() const
+{
+	uint64_t taken = samples_taken.load(std::memory_order_relaxed);
+	return static_cast<size_t>(taken < SAMPLE_COUNT ? taken : SAMPLE_COUNT);
+}
+
+inline const THistogram& TOpStats::GetPutLatency() const
+{
+	return put_latency;
+}
+
+inline const THistogram& TOpStats::GetGetLatency() const
+{
+	return get_latency;
+}
+
+inline const THistogram& TOpStats::GetOccupancy() const
+{
+	return occupancy;
+}
+
+inline void TOpStats::DumpJSON(std::ostream& out) const
+{
+	out << "{\"puts\":" << GetPuts() << ",\"gets\":" << GetGets()
+		<< ",\"full_rejections\":" << GetFullRejections() << ",\"empty_rejections\":" << GetEmptyRejections()
+		<< ",\"high_water\":" << GetHighWater() << ",\"put_latency_ns\":";
+	put_latency.DumpJSON(out);
+	out << ",\"get_latency_ns\":";
+	get_latency.DumpJSON(out);
+	out << ",\"occupancy\":";
+	occupancy.DumpJSON(out);
+
+	out << ",\"occupancy_samples\":[";
+	uint64_t taken = samples_taken.load(std::memory_order_relaxed);
+	uint64_t first = taken > SAMPLE_COUNT ? taken - SAMPLE_COUNT : 0;
+	for (uint64_t i = first; i < taken; ++i) {
+		const TSample& sample = samples[i % SAMPLE_COUNT];
+		if (i != first) out << ",";
+		out << "[" << sample.time.load(std::memory_order_relaxed) << "," << sample.size.load(std::memory_order_relaxed) << "]";
+	}
+	out << "]}";
+}
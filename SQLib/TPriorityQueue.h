@@ -0,0 +1,227 @@
+#pragma once
+#include <functional>
+#include <iostream>
+#include <utility>
+
+#include "TError.hpp"
+#include "TVector_AdvImp.h"
+
+// Priority queue on a 4-ary heap: the four children of a slot are adjacent and
+// usually share one cache line, and the tree is half as deep as a binary heap.
+// Top() is the greatest element according to Compare (as in std::priority_queue).
+// Put returns a handle which stays valid until the element leaves the queue
+// and can be used to change its key or remove it.
+template<class T, class Compare = std::less<T>>
+class TPriorityQueue {
+protected:
+	static constexpr size_t ARITY = 4;
+
+	TVector<T> heap;
+	TVector<size_t> slot_handle;
+	TVector<size_t> handle_slot;
+	TVector<size_t> free_handles;
+	Compare compare;
+
+	size_t NewHandle(size_t slot);
+	void SiftUp(size_t slot);
+	void SiftDown(size_t slot);
+	void RemoveSlot(size_t slot);
+
+public:
+	static constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
+	TPriorityQueue(const Compare& compare_ = Compare());
+	template<class Iterator>
+	TPriorityQueue(Iterator first, Iterator last, const Compare& compare_ = Compare());
+
+	size_t GetSize() const;
+	bool IsEmpty() const;
+	bool Contains(size_t handle) const;
+
+	const T& Top() const;
+	const T& operator[](size_t handle) const;
+
+	size_t Put(const T& value);
+	T Get();
+
+	void Update(size_t handle, const T& value);
+	void Erase(size_t handle);
+};
+
+template<class T, class Compare>
+inline TPriorityQueue<T, Compare>::TPriorityQueue(const Compare& compare_) : compare(compare_) {}
+
+template<class T, class Compare>
+template<class Iterator>
+inline TPriorityQueue<T, Compare>::TPriorityQueue(Iterator first, Iterator last, const Compare& compare_)
+	: compare(compare_)
+{
+	for (; first != last; ++first) {
+		slot_handle.push_back(handle_slot.GetSize());
+		handle_slot.push_back(heap.GetSize());
+		heap.push_back(*first);
+	}
+
+	size_t size = heap.GetSize();
+	if (size > 1) {
+		for (size_t slot = (size - 2) / ARITY + 1; slot-- > 0;) SiftDown(slot);
+	}
+}
+
+template<class T, class Compare>
+inline size_t TPriorityQueue<T, Compare>::NewHandle(size_t slot)
+{
+	if (free_handles.IsEmpty()) {
+		handle_slot.push_back(slot);
+		return handle_slot.GetSize() - 1;
+	}
+	size_t handle = free_handles[free_handles.GetSize() - 1];
+	free_handles.pop_back();
+	handle_slot[handle] = slot;
+	return handle;
+}
+
+template<class T, class Compare>
+inline void TPriorityQueue<T, Compare>::SiftUp(size_t slot)
+{
+	T* h = heap.begin();
+	size_t* sh = slot_handle.begin();
+	size_t* hs = handle_slot.begin();
+
+	T value = std::move(h[slot]);
+	size_t handle = sh[slot];
+	while (slot > 0) {
+		size_t parent = (slot - 1) / ARITY;
+		if (!compare(h[parent], value)) break;
+		h[slot] = std::move(h[parent]);
+		sh[slot] = sh[parent];
+		hs[sh[slot]] = slot;
+		slot = parent;
+	}
+	h[slot] = std::move(value);
+	sh[slot] = handle;
+	hs[handle] = slot;
+}
+
+template<class T, class Compare>
+inline void TPriorityQueue<T, Compare>::SiftDown(size_t slot)
+{
+	T* h = heap.begin();
+	size_t* sh = slot_handle.begin();
+	size_t* hs = handle_slot.begin();
+	size_t size = heap.GetSize();
+
+	T value = std::move(h[slot]);
+	size_t handle = sh[slot];
+	while (true) {
+		size_t first_child = slot * ARITY + 1;
+		if (first_child >= size) break;
+		size_t last_child = first_child + ARITY < size ? first_child + ARITY : size;
+
+		size_t best = first_child;
+		for (size_t child = first_child + 1; child < last_child; ++child) {
+			if (compare(h[best], h[child])) best = child;
+		}
+		if (!compare(value, h[best])) break;
+
+		h[slot] = std::move(h[best]);
+		sh[slot] = sh[best];
+		hs[sh[slot]] = slot;
+		slot = best;
+	}
+	h[slot] = std::move(value);
+	sh[slot] = handle;
+	hs[handle] = slot;
+}
+
+template<class T, class Compare>
+inline void TPriorityQueue<T, Compare>::RemoveSlot(size_t slot)
+{
+	size_t handle = slot_handle[slot];
+	handle_slot[handle] = NO_SLOT;
+	free_handles.push_back(handle);
+
+	size_t last = heap.GetSize() - 1;
+	if (slot != last) {
+		heap[slot] = std::move(heap[last]);
+		slot_handle[slot] = slot_handle[last];
+		handle_slot[slot_handle[slot]] = slot;
+	}
+	heap.pop_back();
+	slot_handle.pop_back();
+
+	if (slot < last) {
+		if (slot > 0 && compare(heap[(slot - 1) / ARITY], heap[slot])) SiftUp(slot);
+		else SiftDown(slot);
+	}
+}
+
+template<class T, class Compare>
+inline size_t TPriorityQueue<T, Compare>::GetSize() const
+{
+	return heap.GetSize();
+}
+
+template<class T, class Compare>
+inline bool TPriorityQueue<T, Compare>::IsEmpty() const
+{
+	return heap.IsEmpty();
+}
+
+template<class T, class Compare>
+inline bool TPriorityQueue<T, Compare>::Contains(size_t handle) const
+{
+	return handle < handle_slot.GetSize() && handle_slot[handle] != NO_SLOT;
+}
+
+template<class T, class Compare>
+inline const T& TPriorityQueue<T, Compare>::Top() const
+{
+	if (IsEmpty()) throw TError("Queue is empty", __func__, __FILE__, __LINE__);
+	return heap[0];
+}
+
+template<class T, class Compare>
+inline const T& TPriorityQueue<T, Compare>::operator[](size_t handle) const
+{
+	if (!Contains(handle)) throw TError("Incorrect handle", __func__, __FILE__, __LINE__);
+	return heap[handle_slot[handle]];
+}
+
+template<class T, class Compare>
+inline size_t TPriorityQueue<T, Compare>::Put(const T& value)
+{
+	size_t slot = heap.GetSize();
+	size_t handle = NewHandle(slot);
+	heap.push_back(value);
+	slot_handle.push_back(handle);
+	SiftUp(slot);
+	return handle;
+}
+
+template<class T, class Compare>
+inline T TPriorityQueue<T, Compare>::Get()
+{
+	if (IsEmpty()) throw TError("Queue is empty", __func__, __FILE__, __LINE__);
+	T value = std::move(heap[0]);
+	RemoveSlot(0);
+	return value;
+}
+
+template<class T, class Compare>
+inline void TPriorityQueue<T, Compare>::Update(size_t handle, const T& value)
+{
+	if (!Contains(handle)) throw TError("Incorrect handle", __func__, __FILE__, __LINE__);
+	size_t slot = handle_slot[handle];
+	bool raised = compare(heap[slot], value);
+	heap[slot] = value;
+	if (raised) SiftUp(slot);
+	else SiftDown(slot);
+}
+
+template<class T, class Compare>
+inline void TPriorityQueue<T, Compare>::Erase(size_t handle)
+{
+	if (!Contains(handle)) throw TError("Incorrect handle", __func__, __FILE__, __LINE__);
+	RemoveSlot(handle_slot[handle]);
+}
@@ -1,12 +1,16 @@
 #pragma once
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <initializer_list>
+#include <iterator>
+#include <cstddef>
 
 #include "TError.hpp"
+#include "TOpStats.h"
 #include "TString_Adv.h"
 
-template<class T>
+template<class T, class Stats = TNoStats>
 class TQueue {
 protected:
 	size_t capacity;
@@ -14,16 +18,20 @@ protected:
 	size_t tail;
 	size_t count;
 	T* data;
+	[[no_unique_address]] Stats stats;
+
+	size_t Physical(size_t index) const;
 
 public:
 	TQueue();
 	TQueue(size_t capacity_);
-	TQueue(const TQueue<T>& other);
-	TQueue(TQueue<T>&& other) noexcept;
+	TQueue(const TQueue<T, Stats>& other);
+	TQueue(TQueue<T, Stats>&& other) noexcept;
 	TQueue(const TString& filename);
 	~TQueue();
 
-	size_t GetSize();
+	size_t GetSize() const;
+	size_t GetCapacity() const;
 	size_t GetHead();
 	size_t GetTail();
 
@@ -33,163 +41,360 @@ public:
 	bool IsFull() const;
 	bool IsEmpty()const;
 
-	TQueue& operator=(const TQueue<T>& other);
-	TQueue& operator=(TQueue<T>&& other) noexcept;
+	TQueue& operator=(const TQueue<T, Stats>& other);
+	TQueue& operator=(TQueue<T, Stats>&& other) noexcept;
 
-	bool operator==(const TQueue<T>& other);
-	bool operator!=(const TQueue<T>& other);
+	bool operator==(const TQueue<T, Stats>& other);
+	bool operator!=(const TQueue<T, Stats>& other);
 
 	T operator[](const size_t& index);
 	const T operator[](const size_t& index) const;
 
+	T& At(const size_t& index);
+	const T& At(const size_t& index) const;
+
 	void SaveToFile(const TString& filename);
 
 	
 	T FindMin() const;
 
-	template<class O>
-	friend std::ostream& operator<<(std::ostream& out, const TQueue<O>& other);
+	const Stats& GetStats() const;
+
+	// Contiguous run of elements inside the ring buffer.
+	template<class P>
+	class TSpanOf {
+	private:
+		P first;
+		P last;
+
+	public:
+		TSpanOf() : first(nullptr), last(nullptr) {}
+		TSpanOf(P first_, P last_) : first(first_), last(last_) {}
+
+		P begin() const noexcept {
+			return first;
+		}
+
+		P end() const noexcept {
+			return last;
+		}
+
+		size_t GetSize() const noexcept {
+			return static_cast<size_t>(last - first);
+		}
+	};
+
+	using TSpan = TSpanOf<T*>;
+	using TConstSpan = TSpanOf<const T*>;
+
+	// The queue as at most two spans: head..end of buffer, then start of buffer..tail.
+	template<class Span>
+	class TSpanList {
+	private:
+		Span spans[2];
+		size_t count_spans;
+
+	public:
+		TSpanList() : count_spans(0) {}
+
+		void Add(const Span& span) {
+			spans[count_spans++] = span;
+		}
+
+		size_t GetCount() const noexcept {
+			return count_spans;
+		}
+
+		const Span& operator[](size_t index) const {
+			return spans[index];
+		}
+
+		const Span* begin() const noexcept {
+			return spans;
+		}
+
+		const Span* end() const noexcept {
+			return spans + count_spans;
+		}
+	};
+
+	// Spans/ForEachSpan walk the elements without the per-step index check and
+	// wrap-around of the iterators, so the inner loops are plain pointer loops:
+	//     for (const auto& span : queue.Spans())
+	//         for (T& value : span) ...
+	TSpanList<TSpan> Spans() noexcept;
+	TSpanList<TConstSpan> Spans() const noexcept;
+
+	template<class F>
+	void ForEachSpan(F f);
+	template<class F>
+	void ForEachSpan(F f) const;
+
+	template<class F>
+	void ForEach(F f);
+	template<class F>
+	void ForEach(F f) const;
+
+	template<class O, class S>
+	friend std::ostream& operator<<(std::ostream& out, const TQueue<O, S>& other);
 
 	class TIterator {
 	private:
-		TQueue<T>* queue;
-		size_t current_index;
-		size_t steps;
+		TQueue<T, Stats>* queue;
+		size_t index;
 
 	public:
-		TIterator(TQueue<T>* q, size_t idx, size_t s = 0)
-			: queue(q), current_index(idx), steps(s) {
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		TIterator() : queue(nullptr), index(0) {}
+		TIterator(TQueue<T, Stats>* q, size_t idx) : queue(q), index(idx) {}
+
+		T& operator*() const {
+			return queue->data[queue->Physical(index)];
 		}
 
-		T& operator*() {
-			return queue->data[current_index];
+		T* operator->() const {
+			return &(queue->data[queue->Physical(index)]);
 		}
 
-		T* operator->() {
-			return &(queue->data[current_index]);
+		T& operator[](difference_type n) const {
+			return queue->data[queue->Physical(index + n)];
 		}
 
 		TIterator& operator++() {
-			if (steps < queue->count) {
-				current_index = (current_index + 1) % queue->capacity;
-				steps++;
-			}
+			++index;
 			return *this;
 		}
 
 		TIterator operator++(int) {
 			TIterator temp = *this;
-			++(*this);
+			++index;
+			return temp;
+		}
+
+		TIterator& operator--() {
+			--index;
+			return *this;
+		}
+
+		TIterator operator--(int) {
+			TIterator temp = *this;
+			--index;
 			return temp;
 		}
 
+		TIterator& operator+=(difference_type n) {
+			index += n;
+			return *this;
+		}
+
+		TIterator& operator-=(difference_type n) {
+			index -= n;
+			return *this;
+		}
+
+		TIterator operator+(difference_type n) const {
+			return TIterator(queue, index + n);
+		}
+
+		friend TIterator operator+(difference_type n, const TIterator& it) {
+			return it + n;
+		}
+
+		TIterator operator-(difference_type n) const {
+			return TIterator(queue, index - n);
+		}
+
+		difference_type operator-(const TIterator& other) const {
+			return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+		}
+
 		bool operator==(const TIterator& other) const {
-			return queue == other.queue && steps == other.steps;
+			return queue == other.queue && index == other.index;
 		}
 
 		bool operator!=(const TIterator& other) const {
 			return !(*this == other);
 		}
+
+		bool operator<(const TIterator& other) const {
+			return index < other.index;
+		}
+
+		bool operator>(const TIterator& other) const {
+			return index > other.index;
+		}
+
+		bool operator<=(const TIterator& other) const {
+			return index <= other.index;
+		}
+
+		bool operator>=(const TIterator& other) const {
+			return index >= other.index;
+		}
 	};
 
 	class TConstIterator {
 	private:
-		const TQueue<T>* queue;
-		size_t current_index;
-		size_t steps;
+		const TQueue<T, Stats>* queue;
+		size_t index;
 
 	public:
-		TConstIterator(const TQueue<T>* q, size_t idx, size_t s = 0)
-			: queue(q), current_index(idx), steps(s) {
-		}
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+		TConstIterator() : queue(nullptr), index(0) {}
+		TConstIterator(const TQueue<T, Stats>* q, size_t idx) : queue(q), index(idx) {}
 
 		const T& operator*() const {
-			return queue->data[current_index];
+			return queue->data[queue->Physical(index)];
 		}
 
 		const T* operator->() const {
-			return &(queue->data[current_index]);
+			return &(queue->data[queue->Physical(index)]);
+		}
+
+		const T& operator[](difference_type n) const {
+			return queue->data[queue->Physical(index + n)];
 		}
 
 		TConstIterator& operator++() {
-			if (steps < queue->count) {
-				current_index = (current_index + 1) % queue->capacity;
-				steps++;
-			}
+			++index;
 			return *this;
 		}
 
 		TConstIterator operator++(int) {
 			TConstIterator temp = *this;
-			++(*this);
+			++index;
 			return temp;
 		}
 
+		TConstIterator& operator--() {
+			--index;
+			return *this;
+		}
+
+		TConstIterator operator--(int) {
+			TConstIterator temp = *this;
+			--index;
+			return temp;
+		}
+
+		TConstIterator& operator+=(difference_type n) {
+			index += n;
+			return *this;
+		}
+
+		TConstIterator& operator-=(difference_type n) {
+			index -= n;
+			return *this;
+		}
+
+		TConstIterator operator+(difference_type n) const {
+			return TConstIterator(queue, index + n);
+		}
+
+		friend TConstIterator operator+(difference_type n, const TConstIterator& it) {
+			return it + n;
+		}
+
+		TConstIterator operator-(difference_type n) const {
+			return TConstIterator(queue, index - n);
+		}
+
+		difference_type operator-(const TConstIterator& other) const {
+			return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+		}
+
 		bool operator==(const TConstIterator& other) const {
-			return queue == other.queue && steps == other.steps;
+			return queue == other.queue && index == other.index;
 		}
 
 		bool operator!=(const TConstIterator& other) const {
 			return !(*this == other);
 		}
+
+		bool operator<(const TConstIterator& other) const {
+			return index < other.index;
+		}
+
+		bool operator>(const TConstIterator& other) const {
+			return index > other.index;
+		}
+
+		bool operator<=(const TConstIterator& other) const {
+			return index <= other.index;
+		}
+
+		bool operator>=(const TConstIterator& other) const {
+			return index >= other.index;
+		}
 	};
 
+	// begin()/end() stay random-access iterators over logical positions, so
+	// std::sort, std::lower_bound and iterator arithmetic keep working. That is
+	// also why range-for over the queue is not segmented: one iterator over a
+	// wrapped buffer needs the wrap check on every step whatever its shape, and
+	// only a loop per span becomes a plain pointer loop. Hot loops should use
+	// Spans() or ForEachSpan instead.
 	TIterator begin() noexcept {
-		return TIterator(this, head, 0);
+		return TIterator(this, 0);
 	}
 
 	TIterator end() noexcept {
-		return TIterator(this, tail, count);
+		return TIterator(this, count);
 	}
 
 	TConstIterator begin() const noexcept {
-		return TConstIterator(this, head, 0);
+		return TConstIterator(this, 0);
 	}
 
 	TConstIterator end() const noexcept {
-		return TConstIterator(this, tail, count);
+		return TConstIterator(this, count);
 	}
 
 	TConstIterator cbegin() const noexcept {
-		return TConstIterator(this, head, 0);
+		return TConstIterator(this, 0);
 	}
 
 	TConstIterator cend() const noexcept {
-		return TConstIterator(this, tail, count);
+		return TConstIterator(this, count);
 	}
 
 };
 
-template<class T>
-inline TQueue<T>::TQueue() : capacity(0), head(0), tail(0), count(0), data(nullptr) {}
+template<class T, class Stats>
+inline TQueue<T, Stats>::TQueue() : capacity(0), head(0), tail(0), count(0), data(nullptr) {}
 
-template<class T>
-inline TQueue<T>::TQueue(size_t capacity_) : capacity (capacity_), head(0), tail(0), count(0)
+template<class T, class Stats>
+inline TQueue<T, Stats>::TQueue(size_t capacity_) : capacity (capacity_), head(0), tail(0), count(0)
 {
 	if (capacity == 0) data = nullptr;
 	else data = new T[capacity];
 }
 
 
-template<class T>
-inline TQueue<T>::TQueue(const TQueue<T>& other) : capacity(other.capacity), head(other.head), tail(other.tail), count(other.count)
+template<class T, class Stats>
+inline TQueue<T, Stats>::TQueue(const TQueue<T, Stats>& other) : capacity(other.capacity), head(other.head), tail(other.tail), count(other.count)
 {
 	if (capacity == 0) data = nullptr;
 	else {
 		data = new T[capacity];
-
-		if (head < tail) {
-			for (auto i = head; i < tail; i++) data[i] = other.data[i];
-		}
-		else {
-			for (auto i = head; i < capacity; i++) data[i] = other.data[i];
-			for (auto i = 0; i < tail; i++) data[i] = other.data[i];
-		}
+		other.ForEachSpan([this, &other](const T* first, const T* last) {
+			std::copy(first, last, data + (first - other.data));
+		});
 	}
 }
 
-template<class T>
-inline TQueue<T>::TQueue(TQueue<T>&& other) noexcept : capacity(other.capacity), head(other.head), tail(other.tail), count(other.count)
+template<class T, class Stats>
+inline TQueue<T, Stats>::TQueue(TQueue<T, Stats>&& other) noexcept : capacity(other.capacity), head(other.head), tail(other.tail), count(other.count)
 {
 	data = other.data;
 	other.data = nullptr;
@@ -199,33 +404,30 @@ inline TQueue<T>::TQueue(TQueue<T>&& other) noexcept : capacity(other.capacity),
 	other.count = 0;
 }
 
-template<class T>
-inline TQueue<T>::TQueue(const TString& filename)
+template<class T, class Stats>
+inline TQueue<T, Stats>::TQueue(const TString& filename) : capacity(0), head(0), tail(0), count(0), data(nullptr)
 {
 	std::ifstream file(filename.CStr());
 
 	if (!file.is_open()) throw TError("Cannot open file ", __func__, __FILE__, __LINE__);
 
-	if (file.is_open()) {
-		file >> capacity >> head >> tail >> count;
-		if (capacity >= head && head == tail && count == 0) data = nullptr;
-		else if (head < capacity && tail < capacity) {
-			data = new T[capacity];
-			if (head < tail && count == tail - head) {
-				for (auto i = head; i < tail; i++) file >> data[i];
-			}
-			else if (head >= tail && (count == capacity - head + tail)) {
-				for (auto i = head; i < capacity; i++) file >> data[i];
-				for (auto i = 0; i < tail; i++) file >> data[i];
-			}
-		}
-		else throw TError("Incorrect input", __func__, __FILE__, __LINE__);
-		file.close();
+	file >> capacity >> head >> tail >> count;
+	bool correct = !file.fail() && count <= capacity;
+	if (correct && capacity == 0) correct = (head == 0 && tail == 0);
+	else if (correct) correct = (head < capacity && tail == (head + count) % capacity);
+	if (!correct) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+
+	if (capacity > 0) data = new T[capacity];
+	for (size_t i = 0; i < count; i++) file >> data[Physical(i)];
+	if (file.fail()) {
+		delete[] data;
+		throw TError("Incorrect input", __func__, __FILE__, __LINE__);
 	}
+	file.close();
 }
 
-template<class T>
-inline TQueue<T>::~TQueue()
+template<class T, class Stats>
+inline TQueue<T, Stats>::~TQueue()
 {
 	capacity = 0;
 	head = 0;
@@ -235,72 +437,91 @@ inline TQueue<T>::~TQueue()
 }
 
 
-template<class T>
-inline size_t TQueue<T>::GetSize()
+template<class T, class Stats>
+inline size_t TQueue<T, Stats>::GetSize() const
 {
 	return count;
 }
 
-template<class T>
-inline size_t TQueue<T>::GetHead()
+template<class T, class Stats>
+inline size_t TQueue<T, Stats>::GetCapacity() const
+{
+	return capacity;
+}
+
+template<class T, class Stats>
+inline size_t TQueue<T, Stats>::GetHead()
 {
 	return data[head];
 }
 
-template<class T>
-inline size_t TQueue<T>::GetTail()
+template<class T, class Stats>
+inline size_t TQueue<T, Stats>::GetTail()
 {
 	return data[tail-1];
 }
 
-template<class T>
-inline T TQueue<T>::Get()
+template<class T, class Stats>
+inline T TQueue<T, Stats>::Get()
 {
 	if (!IsEmpty()) {
+		auto stamp = Stats::Start();
 		T value = data[head];
 		count--;
-		head = (head + 1) % capacity;
+		if (++head == capacity) head = 0;
+		stats.OnGet(stamp, count);
 		return value;
 	}
-	else throw TError("Queue is empty", __func__, __FILE__, __LINE__);
+	else {
+		stats.OnEmpty();
+		throw TError("Queue is empty", __func__, __FILE__, __LINE__);
+	}
 }
 
 
-template<class T>
-inline void TQueue<T>::Put(const T& value)
+template<class T, class Stats>
+inline void TQueue<T, Stats>::Put(const T& value)
 {
 	if (!IsFull()) {
+		auto stamp = Stats::Start();
 		count++;
 		data[tail] = value;
-		tail = (tail + 1) % capacity;
+		if (++tail == capacity) tail = 0;
+		stats.OnPut(stamp, count);
+	}
+	else {
+		stats.OnFull();
+		throw TError("Stack is full", __func__, __FILE__, __LINE__);
 	}
-	else throw TError("Stack is full", __func__, __FILE__, __LINE__);
 }
 
-template<class T>
-inline bool TQueue<T>::IsEmpty() const
+template<class T, class Stats>
+inline bool TQueue<T, Stats>::IsEmpty() const
 {
 	return (count == 0);
 }
 
-template<class T>
-inline bool TQueue<T>::IsFull() const
+template<class T, class Stats>
+inline bool TQueue<T, Stats>::IsFull() const
 {
 	return (count == capacity);
 }
 
-template<class T>
-inline TQueue<T>& TQueue<T>::operator=(const TQueue<T>& other)
+template<class T, class Stats>
+inline TQueue<T, Stats>& TQueue<T, Stats>::operator=(const TQueue<T, Stats>& other)
 {
 	if (this != &other) {
 		if (data) delete[] data;
+		ResetStats(stats);
 		count = other.count;
 		head = other.head;
 		tail = other.tail;
 		capacity = other.capacity;
 		if (capacity > 0) {
 			data = new T[capacity];
-			for (auto i = 0; i < capacity; ++i) data[i] = other.data[i];
+			other.ForEachSpan([this, &other](const T* first, const T* last) {
+				std::copy(first, last, data + (first - other.data));
+			});
 		}
 		else data = nullptr;
 		return *this;
@@ -309,8 +530,8 @@ inline TQueue<T>& TQueue<T>::operator=(const TQueue<T>& other)
 }
 
 
-template<class T>
-inline TQueue<T>& TQueue<T>::operator=(TQueue<T>&& other) noexcept
+template<class T, class Stats>
+inline TQueue<T, Stats>& TQueue<T, Stats>::operator=(TQueue<T, Stats>&& other) noexcept
 {
 	if (this != &other) {
 		if (data) delete[] data;
@@ -330,38 +551,28 @@ inline TQueue<T>& TQueue<T>::operator=(TQueue<T>&& other) noexcept
 	return *this;
 }
 
-template<class T>
-inline bool TQueue<T>::operator==(const TQueue<T>& other)
+template<class T, class Stats>
+inline bool TQueue<T, Stats>::operator==(const TQueue<T, Stats>& other)
 {
 	if (capacity != other.capacity || head != other.head || tail != other.tail || count != other.count) {
 		return false;
 	}
-	else if (count == 0) return true;
-	else if (head < tail) {
-		for (auto i = head; i < tail; i++) {
-			if (data[i] != other.data[i]) return false;
-		}
-		return true;
-	}
-	else {
-		for (auto i = head; i < capacity; i++) {
-			if (data[i] != other.data[i]) return false;
-		}
-		for (auto i = 0; i < tail; i++) {
-			if (data[i] != other.data[i]) return false;
-		}
-		return true;
-	}
+
+	bool equal = true;
+	ForEachSpan([&equal, this, &other](const T* first, const T* last) {
+		if (equal) equal = std::equal(first, last, other.data + (first - data));
+	});
+	return equal;
 }
 
-template<class T>
-inline bool TQueue<T>::operator!=(const TQueue<T>& other)
+template<class T, class Stats>
+inline bool TQueue<T, Stats>::operator!=(const TQueue<T, Stats>& other)
 {
 	return !(*this == other);
 }
 
-template<class T>
-inline T TQueue<T>::operator[](const size_t& index)
+template<class T, class Stats>
+inline T TQueue<T, Stats>::operator[](const size_t& index)
 {
 	if (index >= capacity) {
 		throw TError("Index out of range", __func__, __FILE__, __LINE__);
@@ -385,8 +596,8 @@ inline T TQueue<T>::operator[](const size_t& index)
 	throw TError("Index does not point to queue element", __func__, __FILE__, __LINE__);
 }
 
-template<class T>
-inline const T TQueue<T>::operator[](const size_t& index) const
+template<class T, class Stats>
+inline const T TQueue<T, Stats>::operator[](const size_t& index) const
 {
 	if (index >= capacity) {
 		throw TError("Index out of range", __func__, __FILE__, __LINE__);
@@ -409,66 +620,123 @@ inline const T TQueue<T>::operator[](const size_t& index) const
 	throw TError("Index does not point to queue element", __func__, __FILE__, __LINE__);
 }
 
-template<class T>
-inline void TQueue<T>::SaveToFile(const TString& filename)
+template<class T, class Stats>
+inline size_t TQueue<T, Stats>::Physical(size_t index) const
+{
+	size_t position = head + index;
+	return position >= capacity ? position - capacity : position;
+}
+
+template<class T, class Stats>
+inline T& TQueue<T, Stats>::At(const size_t& index)
 {
-	if (count == 0) throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+	if (index >= count) throw TError("Index out of range", __func__, __FILE__, __LINE__);
+	return data[Physical(index)];
+}
 
+template<class T, class Stats>
+inline const T& TQueue<T, Stats>::At(const size_t& index) const
+{
+	if (index >= count) throw TError("Index out of range", __func__, __FILE__, __LINE__);
+	return data[Physical(index)];
+}
+
+template<class T, class Stats>
+inline void TQueue<T, Stats>::SaveToFile(const TString& filename)
+{
 	std::ofstream file(filename.CStr());
 
 	if (!file.is_open()) throw TError("Cannot open file ", __func__, __FILE__, __LINE__);
 
-	if (file.is_open())
-	{
-		file << capacity << " " << head << " " << tail << " " << count << "\n";
-		if (head < tail) {
-			for (auto i = head; i < tail; i++) file << data[i] << " ";
-		}
-		else {
-			for (auto i = head; i < capacity; i++) file << data[i] << " ";
-			for (auto i = 0; i < tail; i++) file << data[i] << " ";
-		}
-	} file.close();
-
+	file << capacity << " " << head << " " << tail << " " << count << "\n";
+	ForEach([&file](const T& value) { file << value << " "; });
+	file.close();
 }
 
-template<class T>
-inline T TQueue<T>::FindMin() const
+template<class T, class Stats>
+inline T TQueue<T, Stats>::FindMin() const
 {
 	if (!(IsEmpty())) {
 		T buffer = data[head];
-		if (head < tail) {
-			for (auto i = head; i < tail; i++) {
-				if (data[i] < buffer) buffer = data[i];
-			}
-		}
-		else {
-			for (auto i = head; i < capacity; i++) {
-				if (data[i] < buffer) buffer = data[i];
-			}
-			for (auto i = 0; i < tail; i++) {
-				if (data[i] < buffer) buffer = data[i];
-			}
-		}
+		ForEach([&buffer](const T& value) {
+			if (value < buffer) buffer = value;
+		});
 		return buffer;
 	}
 	else throw TError("Stack is empty", __func__, __FILE__, __LINE__);
 }
 
+template<class T, class Stats>
+inline typename TQueue<T, Stats>::template TSpanList<typename TQueue<T, Stats>::TSpan> TQueue<T, Stats>::Spans() noexcept
+{
+	TSpanList<TSpan> spans;
+	if (count == 0) return spans;
+	size_t first_size = count < capacity - head ? count : capacity - head;
+	spans.Add(TSpan(data + head, data + head + first_size));
+	if (first_size < count) spans.Add(TSpan(data, data + (count - first_size)));
+	return spans;
+}
 
+template<class T, class Stats>
+inline typename TQueue<T, Stats>::template TSpanList<typename TQueue<T, Stats>::TConstSpan> TQueue<T, Stats>::Spans() const noexcept
+{
+	TSpanList<TConstSpan> spans;
+	if (count == 0) return spans;
+	size_t first_size = count < capacity - head ? count : capacity - head;
+	spans.Add(TConstSpan(data + head, data + head + first_size));
+	if (first_size < count) spans.Add(TConstSpan(data, data + (count - first_size)));
+	return spans;
+}
 
-template<class O>
-inline std::ostream& operator<<(std::ostream& out, const TQueue<O>& other)
+template<class T, class Stats>
+template<class F>
+inline void TQueue<T, Stats>::ForEachSpan(F f)
 {
-	out << "{ ";
-	if (!other.IsEmpty()) {
-		size_t current = other.head;
-		for (size_t i = 0; i < other.count; i++) {
-			out << other.data[current];
-			if (i < other.count - 1) out << "; ";
-			current = (current + 1) % other.capacity;
-		}
+	for (const TSpan& span : Spans()) f(span.begin(), span.end());
+}
+
+template<class T, class Stats>
+template<class F>
+inline void TQueue<T, Stats>::ForEachSpan(F f) const
+{
+	for (const TConstSpan& span : Spans()) f(span.begin(), span.end());
+}
+
+template<class T, class Stats>
+template<class F>
+inline void TQueue<T, Stats>::ForEach(F f)
+{
+	for (const TSpan& span : Spans()) {
+		for (T* it = span.begin(); it != span.end(); ++it) f(*it);
 	}
+}
+
+template<class T, class Stats>
+template<class F>
+inline void TQueue<T, Stats>::ForEach(F f) const
+{
+	for (const TConstSpan& span : Spans()) {
+		for (const T* it = span.begin(); it != span.end(); ++it) f(*it);
+	}
+}
+
+template<class T, class Stats>
+inline const Stats& TQueue<T, Stats>::GetStats() const
+{
+	return stats;
+}
+
+
+template<class O, class S>
+inline std::ostream& operator<<(std::ostream& out, const TQueue<O, S>& other)
+{
+	out << "{ ";
+	bool first = true;
+	other.ForEach([&out, &first](const O& value) {
+		if (!first) out << "; ";
+		out << value;
+		first = false;
+	});
 	out << " }";
 	return out;
 }
\ No newline at end of file
@@ -0,0 +1,213 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "TError.hpp"
+
+// Single-producer single-consumer ring of variable-length byte records. Each
+// record is stored inline as an 8-byte header with its length followed by the
+// payload, rounded up to 8 bytes, so no record needs an allocation of its own.
+// A record never wraps: if it doesn't fit before the end of the buffer, the rest
+// of the buffer is marked with a padding header and the record starts at offset 0.
+//
+// Producer: Reserve(size) returns space for a payload, Commit(size) publishes it
+// (possibly shorter than reserved). Consumer: Peek(size) returns the oldest record
+// in place, Release() frees it. head and tail are free-running byte counters on
+// separate cache lines; each side caches the other's counter like TSharedQueue.
+class TRecordRing {
+public:
+	static constexpr size_t ALIGN = 8;
+	static constexpr size_t HEADER_SIZE = 8;
+
+protected:
+	static constexpr size_t CACHE_LINE = 64;
+	static constexpr uint32_t PADDING = 0xFFFFFFFFu;
+
+	char* data;
+	size_t capacity;
+
+	alignas(CACHE_LINE) std::atomic<uint64_t> head;
+	uint64_t cached_tail;
+	size_t peeked;
+
+	alignas(CACHE_LINE) std::atomic<uint64_t> tail;
+	uint64_t cached_head;
+	uint64_t reserved_at;
+	size_t reserved;
+	bool reserving;
+
+	static size_t Align(size_t size);
+	void WriteHeader(size_t offset, uint32_t value);
+	uint32_t ReadHeader(size_t offset) const;
+	bool HasRoom(uint64_t t, size_t size);
+
+public:
+	TRecordRing(size_t capacity_);
+	TRecordRing(const TRecordRing& other) = delete;
+	TRecordRing& operator=(const TRecordRing& other) = delete;
+	~TRecordRing();
+
+	size_t GetCapacity() const;
+	size_t GetUsed() const;
+	size_t GetMaxRecord() const;
+	bool IsEmpty() const;
+
+	char* Reserve(size_t size);
+	void Commit(size_t size);
+
+	const char* Peek(size_t& size);
+	void Release();
+
+	bool TryPut(const void* record, size_t size);
+};
+
+inline TRecordRing::TRecordRing(size_t capacity_)
+	: data(nullptr), capacity(Align(capacity_)), head(0), cached_tail(0), peeked(0),
+	  tail(0), cached_head(0), reserved_at(0), reserved(0), reserving(false)
+{
+	if (capacity < 2 * HEADER_SIZE) throw TError("Capacity is too small", __func__, __FILE__, __LINE__);
+	data = new char[capacity];
+}
+
+inline TRecordRing::~TRecordRing()
+{
+	delete[] data;
+}
+
+inline size_t TRecordRing::Align(size_t size)
+{
+	return (size + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+inline void TRecordRing::WriteHeader(size_t offset, uint32_t value)
+{
+	std::memcpy(data + offset, &value, sizeof(value));
+}
+
+inline uint32_t TRecordRing::ReadHeader(size_t offset) const
+{
+	uint32_t value;
+	std::memcpy(&value, data + offset, sizeof(value));
+	return value;
+}
+
+inline size_t TRecordRing::GetCapacity() const
+{
+	return capacity;
+}
+
+inline size_t TRecordRing::GetUsed() const
+{
+	uint64_t t = tail.load(std::memory_order_acquire);
+	uint64_t h = head.load(std::memory_order_acquire);
+	return static_cast<size_t>(t - h);
+}
+
+inline size_t TRecordRing::GetMaxRecord() const
+{
+	return capacity - HEADER_SIZE;
+}
+
+inline bool TRecordRing::IsEmpty() const
+{
+	return GetUsed() == 0;
+}
+
+// Whether size bytes from the producer position t are free.
+inline bool TRecordRing::HasRoom(uint64_t t, size_t size)
+{
+	if (t + size - cached_head > capacity) {
+		cached_head = head.load(std::memory_order_acquire);
+		if (t + size - cached_head > capacity) return false;
+	}
+	return true;
+}
+
+// Returns space for a payload of size bytes, or nullptr if the ring has no room
+// now. Only one reservation may be outstanding; Reserve again replaces it.
+inline char* TRecordRing::Reserve(size_t size)
+{
+	if (size > GetMaxRecord() || size > UINT32_MAX - ALIGN)
+		throw TError("Record is too large", __func__, __FILE__, __LINE__);
+
+	uint64_t t = tail.load(std::memory_order_relaxed);
+	size_t offset = static_cast<size_t>(t % capacity);
+	size_t needed = HEADER_SIZE + Align(size);
+	size_t contiguous = capacity - offset;
+
+	// A record that doesn't fit before the end and also doesn't fit together
+	// with the padding (it is larger than offset) could never be placed in one
+	// step, even in an empty ring. The padding is published alone, which drops
+	// any outstanding reservation; the record goes to offset 0 once the
+	// consumer has passed the padding.
+	if (needed > contiguous && contiguous + needed > capacity) {
+		if (!HasRoom(t, contiguous)) return nullptr;
+		WriteHeader(offset, PADDING);
+		reserving = false;
+		t += contiguous;
+		tail.store(t, std::memory_order_release);
+		offset = 0;
+		contiguous = capacity;
+	}
+
+	size_t total = needed <= contiguous ? needed : contiguous + needed;
+	if (!HasRoom(t, total)) return nullptr;
+
+	if (needed > contiguous) {
+		WriteHeader(offset, PADDING);
+		offset = 0;
+	}
+	reserved_at = t + (total - needed);
+	reserved = size;
+	reserving = true;
+	return data + offset + HEADER_SIZE;
+}
+
+inline void TRecordRing::Commit(size_t size)
+{
+	if (!reserving) throw TError("Nothing is reserved", __func__, __FILE__, __LINE__);
+	if (size > reserved) throw TError("Commit is larger than reservation", __func__, __FILE__, __LINE__);
+	WriteHeader(static_cast<size_t>(reserved_at % capacity), static_cast<uint32_t>(size));
+	reserving = false;
+	tail.store(reserved_at + HEADER_SIZE + Align(size), std::memory_order_release);
+}
+
+// Returns the oldest record in place and its size, or nullptr if the ring is
+// empty. The pointer stays valid until Release.
+inline const char* TRecordRing::Peek(size_t& size)
+{
+	uint64_t h = head.load(std::memory_order_relaxed);
+	while (true) {
+		if (h == cached_tail) {
+			cached_tail = tail.load(std::memory_order_acquire);
+			if (h == cached_tail) return nullptr;
+		}
+
+		size_t offset = static_cast<size_t>(h % capacity);
+		uint32_t length = ReadHeader(offset);
+		if (length != PADDING) {
+			size = length;
+			peeked = HEADER_SIZE + Align(length);
+			return data + offset + HEADER_SIZE;
+		}
+		h += capacity - offset;
+		head.store(h, std::memory_order_release);
+	}
+}
+
+inline void TRecordRing::Release()
+{
+	if (peeked == 0) throw TError("No record to release", __func__, __FILE__, __LINE__);
+	head.store(head.load(std::memory_order_relaxed) + peeked, std::memory_order_release);
+	peeked = 0;
+}
+
+inline bool TRecordRing::TryPut(const void* record, size_t size)
+{
+	char* place = Reserve(size);
+	if (!place) return false;
+	if (size > 0) std::memcpy(place, record, size);
+	Commit(size);
+	return true;
+}
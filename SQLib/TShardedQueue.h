@@ -0,0 +1,212 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "TError.hpp"
+#include "TQueue.h"
+
+// How a consumer picks the lane it looks at first:
+// Affinity   - the lane of the calling thread, other lanes only when it is empty;
+// RoundRobin - the next lane after the one the previous Get started at; the
+//              turn is kept per queue and per home lane, so threads that share a
+//              home lane take turns together and other queues don't move it.
+enum class TLaneSelection { Affinity, RoundRobin };
+
+// Concurrent queue made of count_lanes TQueue lanes, each with its own mutex and
+// on its own cache line, so producers on different lanes never contend. A
+// producer puts into the lane of its thread (or the lane of a key); a consumer
+// takes from its first lane and scans (steals from) the others when it's empty.
+//
+// Ordering is relaxed:
+// - every lane is FIFO, so elements put by one thread, or with one key, are taken
+//   in the order they were put;
+// - there is no order between lanes: an element can be taken before an older
+//   element of another lane;
+// - TryPut fails when the producer's lane is full even if other lanes have room;
+// - under concurrent Puts, TryGet can fail although an element was put into a
+//   lane it had already scanned.
+template<class T>
+class TShardedQueue {
+protected:
+	static constexpr size_t CACHE_LINE = 64;
+
+	struct alignas(CACHE_LINE) TLane {
+		std::mutex mutex;
+		TQueue<T> queue;
+		std::atomic<size_t> size;
+		// Where the next RoundRobin Get of the threads of this home lane starts.
+		std::atomic<size_t> cursor;
+
+		TLane() : size(0), cursor(0) {}
+	};
+
+	TLane* lanes;
+	size_t count_lanes;
+	size_t lane_capacity;
+	TLaneSelection selection;
+
+	static size_t ThreadIndex();
+	bool PutTo(size_t lane, const T& value);
+
+public:
+	TShardedQueue(size_t capacity_, size_t count_lanes_ = std::thread::hardware_concurrency(),
+		TLaneSelection selection_ = TLaneSelection::Affinity);
+	TShardedQueue(const TShardedQueue<T>& other) = delete;
+	TShardedQueue& operator=(const TShardedQueue<T>& other) = delete;
+	~TShardedQueue();
+
+	size_t GetCountLanes() const;
+	size_t GetLaneCapacity() const;
+	size_t GetCapacity() const;
+	size_t GetSize() const;
+	size_t GetLaneSize(size_t lane) const;
+	bool IsEmpty() const;
+
+	size_t HomeLane() const;
+	size_t LaneOf(size_t key) const;
+
+	bool TryPut(const T& value);
+	bool TryPut(const T& value, size_t key);
+	bool TryGet(T& value);
+
+	void Put(const T& value);
+	T Get();
+};
+
+template<class T>
+inline TShardedQueue<T>::TShardedQueue(size_t capacity_, size_t count_lanes_, TLaneSelection selection_)
+	: lanes(nullptr), count_lanes(count_lanes_ == 0 ? 1 : count_lanes_), lane_capacity(0), selection(selection_)
+{
+	if (capacity_ == 0) throw TError("Capacity can't be 0", __func__, __FILE__, __LINE__);
+	lane_capacity = (capacity_ + count_lanes - 1) / count_lanes;
+	lanes = new TLane[count_lanes];
+	for (size_t i = 0; i < count_lanes; ++i) {
+		lanes[i].queue = TQueue<T>(lane_capacity);
+		lanes[i].cursor.store(i, std::memory_order_relaxed);
+	}
+}
+
+template<class T>
+inline TShardedQueue<T>::~TShardedQueue()
+{
+	delete[] lanes;
+}
+
+template<class T>
+inline size_t TShardedQueue<T>::ThreadIndex()
+{
+	static std::atomic<size_t> next_index(0);
+	thread_local size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+	return index;
+}
+
+template<class T>
+inline bool TShardedQueue<T>::PutTo(size_t lane, const T& value)
+{
+	TLane& target = lanes[lane];
+	std::lock_guard<std::mutex> lock(target.mutex);
+	if (target.queue.IsFull()) return false;
+	target.queue.Put(value);
+	target.size.store(target.queue.GetSize(), std::memory_order_relaxed);
+	return true;
+}
+
+template<class T>
+inline size_t TShardedQueue<T>::GetCountLanes() const
+{
+	return count_lanes;
+}
+
+template<class T>
+inline size_t TShardedQueue<T>::GetLaneCapacity() const
+{
+	return lane_capacity;
+}
+
+template<class T>
+inline size_t TShardedQueue<T>::GetCapacity() const
+{
+	return lane_capacity * count_lanes;
+}
+
+template<class T>
+inline size_t TShardedQueue<T>::GetSize() const
+{
+	size_t size = 0;
+	for (size_t i = 0; i < count_lanes; ++i) size += lanes[i].size.load(std::memory_order_relaxed);
+	return size;
+}
+
+template<class T>
+inline size_t TShardedQueue<T>::GetLaneSize(size_t lane) const
+{
+	if (lane >= count_lanes) throw TError("Index out of range", __func__, __FILE__, __LINE__);
+	return lanes[lane].size.load(std::memory_order_relaxed);
+}
+
+template<class T>
+inline bool TShardedQueue<T>::IsEmpty() const
+{
+	return GetSize() == 0;
+}
+
+template<class T>
+inline size_t TShardedQueue<T>::HomeLane() const
+{
+	return ThreadIndex() % count_lanes;
+}
+
+template<class T>
+inline size_t TShardedQueue<T>::LaneOf(size_t key) const
+{
+	uint64_t mixed = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+	return static_cast<size_t>(mixed >> 32) % count_lanes;
+}
+
+template<class T>
+inline bool TShardedQueue<T>::TryPut(const T& value)
+{
+	return PutTo(HomeLane(), value);
+}
+
+template<class T>
+inline bool TShardedQueue<T>::TryPut(const T& value, size_t key)
+{
+	return PutTo(LaneOf(key), value);
+}
+
+template<class T>
+inline bool TShardedQueue<T>::TryGet(T& value)
+{
+	size_t start = HomeLane();
+	if (selection == TLaneSelection::RoundRobin)
+		start = lanes[start].cursor.fetch_add(1, std::memory_order_relaxed) % count_lanes;
+
+	for (size_t i = 0; i < count_lanes; ++i) {
+		TLane& lane = lanes[(start + i) % count_lanes];
+		if (lane.size.load(std::memory_order_relaxed) == 0) continue;
+
+		std::lock_guard<std::mutex> lock(lane.mutex);
+		if (lane.queue.IsEmpty()) continue;
+		value = lane.queue.Get();
+		lane.size.store(lane.queue.GetSize(), std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+template<class T>
+inline void TShardedQueue<T>::Put(const T& value)
+{
+	if (!TryPut(value)) throw TError("Queue is full", __func__, __FILE__, __LINE__);
+}
+
+template<class T>
+inline T TShardedQueue<T>::Get()
+{
+	T value;
+	if (!TryGet(value)) throw TError("Queue is empty", __func__, __FILE__, __LINE__);
+	return value;
+}
@@ -0,0 +1,243 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TError.hpp"
+
+// Single-producer single-consumer ring buffer whose indices and storage live in a
+// shared file mapping (normally a file in /dev/shm), so two processes exchange
+// elements through shared memory without sockets or copies through the kernel.
+// One process creates the queue with TSharedQueue(path, capacity), the other opens
+// it with TSharedQueue(path). head and tail are free-running counters on separate
+// cache lines; each side caches the other's counter and rereads it only when the
+// queue looks full (producer) or empty (consumer).
+template<class T>
+class TSharedQueue {
+	static_assert(std::is_trivially_copyable<T>::value, "TSharedQueue stores elements as raw bytes");
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "TSharedQueue needs lock-free 64-bit atomics");
+
+protected:
+	static constexpr size_t CACHE_LINE = 64;
+
+	struct THeader {
+		std::atomic<uint64_t> magic;
+		uint64_t element_size;
+		uint64_t capacity;
+		alignas(CACHE_LINE) std::atomic<uint64_t> head;
+		alignas(CACHE_LINE) std::atomic<uint64_t> tail;
+	};
+
+	static constexpr uint64_t MAGIC = 0x5153515348524451ull;
+
+	std::string path;
+	THeader* header;
+	T* data;
+	size_t capacity;
+	size_t mapped_size;
+	uint64_t cached_head;
+	uint64_t cached_tail;
+
+	static size_t DataOffset();
+	void Map(int fd, size_t size);
+
+public:
+	TSharedQueue(const std::string& path_, size_t capacity_);
+	TSharedQueue(const std::string& path_);
+	TSharedQueue(const TSharedQueue<T>& other) = delete;
+	TSharedQueue(TSharedQueue<T>&& other) noexcept;
+	~TSharedQueue();
+
+	TSharedQueue& operator=(const TSharedQueue<T>& other) = delete;
+
+	size_t GetSize() const;
+	size_t GetCapacity() const;
+
+	bool IsEmpty() const;
+	bool IsFull() const;
+
+	bool TryPut(const T& value);
+	bool TryGet(T& value);
+
+	void Put(const T& value);
+	T Get();
+
+	void Unlink();
+};
+
+template<class T>
+inline size_t TSharedQueue<T>::DataOffset()
+{
+	size_t align = alignof(T) > CACHE_LINE ? alignof(T) : CACHE_LINE;
+	return (sizeof(THeader) + align - 1) / align * align;
+}
+
+template<class T>
+inline void TSharedQueue<T>::Map(int fd, size_t size)
+{
+	void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (memory == MAP_FAILED) throw TError("Cannot map file", __func__, __FILE__, __LINE__);
+
+	mapped_size = size;
+	header = static_cast<THeader*>(memory);
+	data = reinterpret_cast<T*>(static_cast<char*>(memory) + DataOffset());
+}
+
+template<class T>
+inline TSharedQueue<T>::TSharedQueue(const std::string& path_, size_t capacity_)
+	: path(path_), header(nullptr), data(nullptr), capacity(capacity_), mapped_size(0), cached_head(0), cached_tail(0)
+{
+	if (capacity == 0) throw TError("Capacity can't be 0", __func__, __FILE__, __LINE__);
+	if (capacity > (SIZE_MAX - DataOffset()) / sizeof(T)) throw TError("Capacity is too large", __func__, __FILE__, __LINE__);
+
+	int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0) throw TError("Cannot open file", __func__, __FILE__, __LINE__);
+
+	size_t size = DataOffset() + capacity * sizeof(T);
+	if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+		close(fd);
+		throw TError("Cannot resize file", __func__, __FILE__, __LINE__);
+	}
+	Map(fd, size);
+
+	header = new (header) THeader();
+	header->element_size = sizeof(T);
+	header->capacity = capacity;
+	header->head.store(0, std::memory_order_relaxed);
+	header->tail.store(0, std::memory_order_relaxed);
+	header->magic.store(MAGIC, std::memory_order_release);
+}
+
+template<class T>
+inline TSharedQueue<T>::TSharedQueue(const std::string& path_)
+	: path(path_), header(nullptr), data(nullptr), capacity(0), mapped_size(0), cached_head(0), cached_tail(0)
+{
+	int fd = open(path.c_str(), O_RDWR);
+	if (fd < 0) throw TError("Cannot open file", __func__, __FILE__, __LINE__);
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < DataOffset()) {
+		close(fd);
+		throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+	}
+	Map(fd, static_cast<size_t>(info.st_size));
+
+	// The creator publishes the header with a release store of magic, so the
+	// other fields are read only after it. capacity comes from the file: it is
+	// checked against the mapping before the size is computed, which could
+	// otherwise overflow and match.
+	bool valid = header->magic.load(std::memory_order_acquire) == MAGIC && header->element_size == sizeof(T);
+	if (valid) {
+		uint64_t slots = header->capacity;
+		valid = slots > 0 && slots <= (mapped_size - DataOffset()) / sizeof(T)
+			&& mapped_size == DataOffset() + slots * sizeof(T);
+		capacity = static_cast<size_t>(slots);
+	}
+	if (!valid) {
+		munmap(header, mapped_size);
+		throw TError("Incorrect input", __func__, __FILE__, __LINE__);
+	}
+	cached_head = header->head.load(std::memory_order_acquire);
+	cached_tail = header->tail.load(std::memory_order_acquire);
+}
+
+template<class T>
+inline TSharedQueue<T>::TSharedQueue(TSharedQueue<T>&& other) noexcept
+	: path(std::move(other.path)), header(other.header), data(other.data), capacity(other.capacity),
+	  mapped_size(other.mapped_size), cached_head(other.cached_head), cached_tail(other.cached_tail)
+{
+	other.header = nullptr;
+	other.data = nullptr;
+	other.capacity = 0;
+	other.mapped_size = 0;
+}
+
+template<class T>
+inline TSharedQueue<T>::~TSharedQueue()
+{
+	if (header) munmap(header, mapped_size);
+}
+
+template<class T>
+inline size_t TSharedQueue<T>::GetSize() const
+{
+	if (!header) return 0;
+	uint64_t tail = header->tail.load(std::memory_order_acquire);
+	uint64_t head = header->head.load(std::memory_order_acquire);
+	return static_cast<size_t>(tail - head);
+}
+
+template<class T>
+inline size_t TSharedQueue<T>::GetCapacity() const
+{
+	return capacity;
+}
+
+template<class T>
+inline bool TSharedQueue<T>::IsEmpty() const
+{
+	return GetSize() == 0;
+}
+
+template<class T>
+inline bool TSharedQueue<T>::IsFull() const
+{
+	return header && GetSize() == capacity;
+}
+
+template<class T>
+inline bool TSharedQueue<T>::TryPut(const T& value)
+{
+	if (!header) return false;
+	uint64_t tail = header->tail.load(std::memory_order_relaxed);
+	if (tail - cached_head == capacity) {
+		cached_head = header->head.load(std::memory_order_acquire);
+		if (tail - cached_head == capacity) return false;
+	}
+	std::memcpy(&data[tail % capacity], &value, sizeof(T));
+	header->tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template<class T>
+inline bool TSharedQueue<T>::TryGet(T& value)
+{
+	if (!header) return false;
+	uint64_t head = header->head.load(std::memory_order_relaxed);
+	if (head == cached_tail) {
+		cached_tail = header->tail.load(std::memory_order_acquire);
+		if (head == cached_tail) return false;
+	}
+	std::memcpy(&value, &data[head % capacity], sizeof(T));
+	header->head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template<class T>
+inline void TSharedQueue<T>::Put(const T& value)
+{
+	if (!TryPut(value)) throw TError("Queue is full", __func__, __FILE__, __LINE__);
+}
+
+template<class T>
+inline T TSharedQueue<T>::Get()
+{
+	T value;
+	if (!TryGet(value)) throw TError("Queue is empty", __func__, __FILE__, __LINE__);
+	return value;
+}
+
+template<class T>
+inline void TSharedQueue<T>::Unlink()
+{
+	unlink(path.c_str());
+}
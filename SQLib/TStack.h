@@ -4,21 +4,23 @@
 #include <initializer_list>
 
 #include "TError.hpp"
+#include "TOpStats.h"
 #include "TString_Adv.h"
 
-template<class T>
+template<class T, class Stats = TNoStats>
 class TStack {
 protected:
 	size_t capacity;
 	size_t top;
 	T* data;
+	[[no_unique_address]] Stats stats;
 
 public:
 	TStack();
 	TStack(const size_t& capacity_);
 	TStack(std::initializer_list<T> init_list, size_t capacity_);
-	TStack(const TStack<T>& other);
-	TStack(TStack<T>&& other) noexcept;
+	TStack(const TStack<T, Stats>& other);
+	TStack(TStack<T, Stats>&& other) noexcept;
 	TStack(const TString& filename);
 	~TStack();
 
@@ -41,11 +43,11 @@ public:
 	bool IsFull() const;
 	bool IsEmpty() const;
 
-	TStack& operator=(const TStack<T>& other);
-	TStack& operator=(TStack<T>&& other) noexcept;
+	TStack& operator=(const TStack<T, Stats>& other);
+	TStack& operator=(TStack<T, Stats>&& other) noexcept;
 
-	bool operator==(const TStack<T>& other);
-	bool operator!=(const TStack<T>& other);
+	bool operator==(const TStack<T, Stats>& other);
+	bool operator!=(const TStack<T, Stats>& other);
 
 	T operator[](const size_t& index);
 	const T operator[](const size_t& index) const;
@@ -54,19 +56,21 @@ public:
 
 	T FindMin();
 
-	template<class O>
-	friend ostream& operator<<(ostream& out, const TStack<O>& other);
+	const Stats& GetStats() const;
+
+	template<class O, class S>
+	friend ostream& operator<<(ostream& out, const TStack<O, S>& other);
 };
 
-template<class T>
-inline TStack<T>::TStack() : capacity(0), top(0), data(nullptr) {}
+template<class T, class Stats>
+inline TStack<T, Stats>::TStack() : capacity(0), top(0), data(nullptr) {}
 
-template<class T>
-inline TStack<T>::TStack(const size_t& capacity_) : capacity(capacity_), top(0), data(new T[capacity]) {}
+template<class T, class Stats>
+inline TStack<T, Stats>::TStack(const size_t& capacity_) : capacity(capacity_), top(0), data(new T[capacity]) {}
 
 
-template<class T>
-inline TStack<T>::TStack(std::initializer_list<T> init_list, size_t capacity_)
+template<class T, class Stats>
+inline TStack<T, Stats>::TStack(std::initializer_list<T> init_list, size_t capacity_)
 {
 	if ( init_list.size() <= capacity_) {
 		top = init_list.size();
@@ -84,8 +88,8 @@ inline TStack<T>::TStack(std::initializer_list<T> init_list, size_t capacity_)
 	else throw TError("Incorrect input", __func__, __FILE__, __LINE__);
 }
 
-template<class T>
-inline TStack<T>::TStack(const TStack<T>& other)
+template<class T, class Stats>
+inline TStack<T, Stats>::TStack(const TStack<T, Stats>& other)
 {
 	capacity = other.capacity;
 
@@ -102,8 +106,8 @@ inline TStack<T>::TStack(const TStack<T>& other)
 	}
 }
 
-template<class T>
-inline TStack<T>::TStack(TStack<T>&& other) noexcept
+template<class T, class Stats>
+inline TStack<T, Stats>::TStack(TStack<T, Stats>&& other) noexcept
 {
 	capacity = other.capacity;
 	top = other.top;
@@ -114,8 +118,8 @@ inline TStack<T>::TStack(TStack<T>&& other) noexcept
 	other.data = nullptr;
 }
 
-template<class T>
-inline TStack<T>::TStack(const TString& filename)
+template<class T, class Stats>
+inline TStack<T, Stats>::TStack(const TString& filename)
 {
 	std::ifstream file(filename.CStr());
 
@@ -132,28 +136,28 @@ inline TStack<T>::TStack(const TString& filename)
 	}
 }
 
-template<class T>
-inline TStack<T>::~TStack()
+template<class T, class Stats>
+inline TStack<T, Stats>::~TStack()
 {
 	capacity = 0;
 	top = 0;
 	if (data != nullptr) delete[] data;
 }
 
-template<class T>
-inline size_t TStack<T>::GetSize() const
+template<class T, class Stats>
+inline size_t TStack<T, Stats>::GetSize() const
 {
 	return top;
 }
 
-template<class T>
-inline size_t TStack<T>::GetCapacity() const
+template<class T, class Stats>
+inline size_t TStack<T, Stats>::GetCapacity() const
 {
 	return capacity;
 }
 
-template <class T>
-inline size_t TStack<T>::GetTopElem() const
+template<class T, class Stats>
+inline size_t TStack<T, Stats>::GetTopElem() const
 {
 	if (IsEmpty()) {
         throw TError("Stack is empty - cannot get top element", __func__, __FILE__, __LINE__);
@@ -161,32 +165,41 @@ inline size_t TStack<T>::GetTopElem() const
     return data[top-1];
 }
 
-template<class T>
-inline T TStack<T>::Get()
+template<class T, class Stats>
+inline T TStack<T, Stats>::Get()
 {
 	if (!IsEmpty()) {
-		return data[--top];
+		auto stamp = Stats::Start();
+		T value = data[--top];
+		stats.OnGet(stamp, top);
+		return value;
+	}
+	else {
+		stats.OnEmpty();
+		throw TError("Stack is empty", __func__, __FILE__, __LINE__);
 	}
-	else throw TError("Stack is empty", __func__, __FILE__, __LINE__); 
 }
 
-template<class T>
-inline void TStack<T>::Put(const T& value)
+template<class T, class Stats>
+inline void TStack<T, Stats>::Put(const T& value)
 {
 	if ( IsFull() ) {
+		stats.OnFull();
 		throw TError("Stack is full", __func__, __FILE__, __LINE__);
 	}
 	else {
+		auto stamp = Stats::Start();
 		data[top++] = value;
+		stats.OnPut(stamp, top);
 	}
 }
 
-template<class T>
-inline void TStack<T>::Reserve(const size_t& new_capacity)
+template<class T, class Stats>
+inline void TStack<T, Stats>::Reserve(const size_t& new_capacity)
 {
 	if (capacity == new_capacity) return;
 	else if (top <= new_capacity) {
-		TStack<T> buff (*this);
+		TStack<T, Stats> buff (*this);
 		if (data) delete[] data;
 		data = new T[new_capacity];
 		for (auto i = 0; i < buff.GetSize(); i++) data[i] = buff[i];
@@ -196,58 +209,59 @@ inline void TStack<T>::Reserve(const size_t& new_capacity)
 }
 
 
-template<class T>
-inline T* TStack<T>::begin() noexcept
+template<class T, class Stats>
+inline T* TStack<T, Stats>::begin() noexcept
 {
 	return data;
 }
 
-template<class T>
-inline const T* TStack<T>::begin() const noexcept
+template<class T, class Stats>
+inline const T* TStack<T, Stats>::begin() const noexcept
 {
 	return data;
 }
 
-template<class T>
-inline const T* TStack<T>::cbegin() const noexcept
+template<class T, class Stats>
+inline const T* TStack<T, Stats>::cbegin() const noexcept
 {
 	return data;
 }
 
-template<class T>
-inline T* TStack<T>::end() noexcept
+template<class T, class Stats>
+inline T* TStack<T, Stats>::end() noexcept
 {
 	return data + top;
 }
 
-template<class T>
-inline const T* TStack<T>::end() const noexcept
+template<class T, class Stats>
+inline const T* TStack<T, Stats>::end() const noexcept
 {
 	return data + top;
 }
 
-template<class T>
-inline const T* TStack<T>::cend() const noexcept
+template<class T, class Stats>
+inline const T* TStack<T, Stats>::cend() const noexcept
 {
 	return data + top;
 }
-template<class T> 
-inline bool TStack<T>::IsFull() const
+template<class T, class Stats>
+inline bool TStack<T, Stats>::IsFull() const
 {
 	return (capacity == top && top != 0);
 }
 
-template<class T>
-inline bool TStack<T>::IsEmpty() const
+template<class T, class Stats>
+inline bool TStack<T, Stats>::IsEmpty() const
 {
 	return top == 0;
 }
 
-template<class T>
-inline TStack<T>& TStack<T>::operator=(const TStack<T>& other)
+template<class T, class Stats>
+inline TStack<T, Stats>& TStack<T, Stats>::operator=(const TStack<T, Stats>& other)
 {
 	if (this != &other) {
 		if (data != nullptr) delete[] data;
+		ResetStats(stats);
 		capacity = other.capacity;
 		top = other.top;
 		if (capacity == 0) return *this;
@@ -260,8 +274,8 @@ inline TStack<T>& TStack<T>::operator=(const TStack<T>& other)
 	else return *this;
 }
 
-template<class T>
-inline TStack<T>& TStack<T>::operator=(TStack<T>&& other) noexcept
+template<class T, class Stats>
+inline TStack<T, Stats>& TStack<T, Stats>::operator=(TStack<T, Stats>&& other) noexcept
 {
 	if (this != &other) {
 		if (data != nullptr) delete[] data;
@@ -276,8 +290,8 @@ inline TStack<T>& TStack<T>::operator=(TStack<T>&& other) noexcept
 	return *this;
 }
 
-template<class T>
-inline bool TStack<T>::operator==(const TStack<T>& other)
+template<class T, class Stats>
+inline bool TStack<T, Stats>::operator==(const TStack<T, Stats>& other)
 {
 	if (capacity == other.capacity && top == other.top) {
 		if (capacity != 0) {
@@ -290,28 +304,28 @@ inline bool TStack<T>::operator==(const TStack<T>& other)
 	else return false;
 }
 
-template<class T>
-inline bool TStack<T>::operator!=(const TStack<T>& other)
+template<class T, class Stats>
+inline bool TStack<T, Stats>::operator!=(const TStack<T, Stats>& other)
 {
 	return !(*this == other);
 }
 
-template<class T>
-inline T TStack<T>::operator[](const size_t& index)
+template<class T, class Stats>
+inline T TStack<T, Stats>::operator[](const size_t& index)
 {
 	if (index < top) return data[index];
 	else throw TError("Incorrect input", __func__, __FILE__, __LINE__);
 }
 
-template<class T>
-inline const T TStack<T>::operator[](const size_t& index) const
+template<class T, class Stats>
+inline const T TStack<T, Stats>::operator[](const size_t& index) const
 {
 	if (index < top) return data[index];
 	else throw TError("Incorrect input", __func__, __FILE__, __LINE__);
 }
 
-template<class T>
-inline void TStack<T>::SaveToFile(const TString& filename)
+template<class T, class Stats>
+inline void TStack<T, Stats>::SaveToFile(const TString& filename)
 {
 	std::ofstream file(filename.CStr());
 
@@ -325,8 +339,8 @@ inline void TStack<T>::SaveToFile(const TString& filename)
 	file.close();
 }
 
-template<class T>
-inline T TStack<T>::FindMin()
+template<class T, class Stats>
+inline T TStack<T, Stats>::FindMin()
 {
 	if ( !(IsEmpty()) ) {
 		T buffer = data[0];
@@ -338,8 +352,14 @@ inline T TStack<T>::FindMin()
 	else throw TError("Stack is empty", __func__, __FILE__, __LINE__);
 }
 
-template<class O>
-inline ostream& operator<<(ostream& out, const TStack<O>& other)
+template<class T, class Stats>
+inline const Stats& TStack<T, Stats>::GetStats() const
+{
+	return stats;
+}
+
+template<class O, class S>
+inline ostream& operator<<(ostream& out, const TStack<O, S>& other)
 {
 	out << "{ ";
 	if ( !(other.IsEmpty()) ) {
@@ -0,0 +1,259 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "TError.hpp"
+#include "TDeque.h"
+#include "TVector_AdvImp.h"
+#include "TWorkStealingDeque.h"
+
+// Thread pool with one TWorkStealingDeque per worker. Tasks submitted from a worker
+// go to the bottom of its own deque (LIFO, cache-warm); tasks submitted from other
+// threads go to a shared injection queue. An idle worker takes from its own deque,
+// then from the injection queue, then steals from the top of the other deques.
+// Threads waiting in Invoke/ParallelFor/WaitIdle run pending tasks instead of
+// blocking, so recursive fork-join code doesn't deadlock the pool.
+class TThreadPool {
+protected:
+	using TTask = std::function<void()>;
+
+	struct TWorker {
+		TWorkStealingDeque<TTask*> deque;
+		std::thread thread;
+	};
+
+	TVector<TWorker*> workers;
+	TDeque<TTask*> injection;
+	std::mutex injection_mutex;
+
+	std::atomic<size_t> queued;
+	std::atomic<size_t> pending;
+	std::atomic<size_t> sleeping;
+	std::atomic<bool> stop;
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+
+	std::mutex error_mutex;
+	std::exception_ptr error;
+
+	static thread_local TThreadPool* current_pool;
+	static thread_local size_t current_index;
+
+	bool IsWorker() const;
+	TTask* FindTask();
+	void RunTask(TTask* task);
+	bool RunPendingTask();
+	void WorkerLoop(size_t index);
+
+public:
+	TThreadPool(size_t count_threads = std::thread::hardware_concurrency());
+	TThreadPool(const TThreadPool& other) = delete;
+	TThreadPool& operator=(const TThreadPool& other) = delete;
+	~TThreadPool();
+
+	size_t GetCountThreads() const;
+
+	void Submit(TTask task);
+	void WaitIdle();
+
+	template<class F1, class F2>
+	void Invoke(const F1& left, const F2& right);
+
+	template<class F>
+	void ParallelFor(size_t first, size_t last, size_t grain, const F& body);
+};
+
+inline thread_local TThreadPool* TThreadPool::current_pool = nullptr;
+inline thread_local size_t TThreadPool::current_index = 0;
+
+inline TThreadPool::TThreadPool(size_t count_threads) : queued(0), pending(0), sleeping(0), stop(false)
+{
+	if (count_threads == 0) count_threads = 1;
+	for (size_t i = 0; i < count_threads; ++i) workers.push_back(new TWorker());
+	for (size_t i = 0; i < count_threads; ++i) workers[i]->thread = std::thread(&TThreadPool::WorkerLoop, this, i);
+}
+
+inline TThreadPool::~TThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		stop.store(true);
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < workers.GetSize(); ++i) workers[i]->thread.join();
+	for (size_t i = 0; i < workers.GetSize(); ++i) delete workers[i];
+}
+
+inline size_t TThreadPool::GetCountThreads() const
+{
+	return workers.GetSize();
+}
+
+inline bool TThreadPool::IsWorker() const
+{
+	return current_pool == this;
+}
+
+inline TThreadPool::TTask* TThreadPool::FindTask()
+{
+	TTask* task = nullptr;
+	size_t count_workers = workers.GetSize();
+	size_t start = IsWorker() ? current_index : 0;
+
+	if (IsWorker() && workers[start]->deque.Pop(task)) {
+		queued.fetch_sub(1);
+		return task;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(injection_mutex);
+		if (!injection.IsEmpty()) task = injection.PopFront();
+	}
+	if (task) {
+		queued.fetch_sub(1);
+		return task;
+	}
+
+	for (size_t i = 1; i <= count_workers; ++i) {
+		size_t victim = (start + i) % count_workers;
+		if (IsWorker() && victim == current_index) continue;
+		if (workers[victim]->deque.Steal(task)) {
+			queued.fetch_sub(1);
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+inline void TThreadPool::RunTask(TTask* task)
+{
+	try {
+		(*task)();
+	}
+	catch (...) {
+		std::lock_guard<std::mutex> lock(error_mutex);
+		if (!error) error = std::current_exception();
+	}
+	delete task;
+
+	if (pending.fetch_sub(1) == 1) {
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		idle.notify_all();
+	}
+}
+
+inline bool TThreadPool::RunPendingTask()
+{
+	TTask* task = FindTask();
+	if (!task) return false;
+	RunTask(task);
+	return true;
+}
+
+inline void TThreadPool::WorkerLoop(size_t index)
+{
+	current_pool = this;
+	current_index = index;
+
+	while (true) {
+		if (RunPendingTask()) continue;
+
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		if (stop.load() && queued.load() == 0) break;
+		sleeping.fetch_add(1);
+		wake.wait(lock, [this] { return stop.load() || queued.load() > 0; });
+		sleeping.fetch_sub(1);
+	}
+}
+
+inline void TThreadPool::Submit(TTask task)
+{
+	TTask* copy = new TTask(std::move(task));
+	pending.fetch_add(1);
+
+	if (IsWorker()) workers[current_index]->deque.Push(copy);
+	else {
+		std::lock_guard<std::mutex> lock(injection_mutex);
+		injection.PushBack(copy);
+	}
+
+	queued.fetch_add(1);
+	if (sleeping.load() > 0) {
+		{ std::lock_guard<std::mutex> lock(sleep_mutex); }
+		wake.notify_one();
+	}
+}
+
+inline void TThreadPool::WaitIdle()
+{
+	while (pending.load() > 0) {
+		if (RunPendingTask()) continue;
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		idle.wait(lock, [this] { return pending.load() == 0 || queued.load() > 0; });
+	}
+
+	std::lock_guard<std::mutex> lock(error_mutex);
+	if (error) {
+		std::exception_ptr first = error;
+		error = nullptr;
+		std::rethrow_exception(first);
+	}
+}
+
+// Runs left here and right as a task, and returns when both are done. An
+// exception from either of them is rethrown here (left's first), not left for
+// WaitIdle.
+template<class F1, class F2>
+inline void TThreadPool::Invoke(const F1& left, const F2& right)
+{
+	std::atomic<bool> done(false);
+	std::exception_ptr right_error;
+	Submit([&right, &done, &right_error] {
+		struct TDone {
+			std::atomic<bool>& flag;
+			~TDone() { flag.store(true, std::memory_order_release); }
+		} guard{ done };
+		try {
+			right();
+		}
+		catch (...) {
+			right_error = std::current_exception();
+		}
+	});
+
+	auto wait_right = [this, &done] {
+		while (!done.load(std::memory_order_acquire)) {
+			if (!RunPendingTask()) std::this_thread::yield();
+		}
+	};
+
+	try {
+		left();
+	}
+	catch (...) {
+		wait_right();
+		throw;
+	}
+	wait_right();
+	if (right_error) std::rethrow_exception(right_error);
+}
+
+template<class F>
+inline void TThreadPool::ParallelFor(size_t first, size_t last, size_t grain, const F& body)
+{
+	if (last <= first) return;
+	if (grain == 0) grain = 1;
+	if (last - first <= grain) {
+		for (size_t i = first; i < last; ++i) body(i);
+		return;
+	}
+
+	size_t middle = first + (last - first) / 2;
+	Invoke([&] { ParallelFor(first, middle, grain, body); },
+		[&] { ParallelFor(middle, last, grain, body); });
+}
@@ -0,0 +1,236 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+
+#include "TError.hpp"
+#include "TDeque.h"
+#include "TQueue.h"
+
+struct TTimerHandle {
+	size_t index;
+	uint32_t generation;
+};
+
+// Hierarchical timing wheel (Varghese & Lauck). LEVELS wheels of SLOTS buckets:
+// a bucket of level k covers SLOTS^k ticks, so timers up to SLOTS^LEVELS ticks
+// ahead are placed directly and later ones wait in the last level and are
+// placed again when it comes round. A bucket is a TQueue of (record, generation)
+// pairs that doubles its capacity when full. When the level-0 wheel wraps, the
+// current bucket of the next level is cascaded down.
+//
+// Schedule and Cancel are O(1). Cancel only bumps the generation of the timer
+// record; the stale bucket entry is dropped when its bucket is drained. Tick and
+// Advance expire a whole bucket per tick and hand each live value to a callback.
+template<class T>
+class TTimerWheel {
+public:
+	static constexpr unsigned SLOT_BITS = 8;
+	static constexpr size_t SLOTS = size_t(1) << SLOT_BITS;
+	static constexpr size_t LEVELS = 4;
+	static constexpr uint64_t RANGE = uint64_t(1) << (SLOT_BITS * LEVELS);
+
+protected:
+	struct TRecord {
+		T value;
+		uint64_t deadline;
+		uint32_t generation;
+		bool active;
+	};
+
+	struct TEntry {
+		size_t index;
+		uint32_t generation;
+	};
+
+	TQueue<TEntry> buckets[LEVELS][SLOTS];
+	TDeque<TRecord> records;
+	TDeque<size_t> free_records;
+	uint64_t now;
+	size_t count;
+
+	void Insert(const TEntry& entry);
+	void Cascade(size_t level);
+	void Release(size_t index);
+
+	template<class F>
+	size_t Expire(F& expire);
+
+public:
+	TTimerWheel(uint64_t start = 0);
+	TTimerWheel(const TTimerWheel<T>& other) = delete;
+	TTimerWheel& operator=(const TTimerWheel<T>& other) = delete;
+
+	uint64_t GetTime() const;
+	size_t GetSize() const;
+	bool IsEmpty() const;
+
+	TTimerHandle Schedule(uint64_t delay, const T& value);
+	bool Cancel(const TTimerHandle& handle);
+	bool IsScheduled(const TTimerHandle& handle) const;
+	uint64_t GetDeadline(const TTimerHandle& handle) const;
+
+	template<class F>
+	size_t Tick(F expire);
+	template<class F>
+	size_t Advance(uint64_t ticks, F expire);
+};
+
+template<class T>
+inline TTimerWheel<T>::TTimerWheel(uint64_t start) : now(start), count(0) {}
+
+template<class T>
+inline void TTimerWheel<T>::Insert(const TEntry& entry)
+{
+	uint64_t deadline = records[entry.index].deadline;
+	uint64_t delta = deadline - now;
+	if (delta >= RANGE) {
+		delta = RANGE - 1;
+		deadline = now + delta;
+	}
+
+	size_t level = 0;
+	while (level + 1 < LEVELS && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) level++;
+	TQueue<TEntry>& bucket = buckets[level][(deadline >> (SLOT_BITS * level)) & (SLOTS - 1)];
+
+	if (bucket.IsFull()) {
+		TQueue<TEntry> bigger(bucket.GetCapacity() ? 2 * bucket.GetCapacity() : 4);
+		while (!bucket.IsEmpty()) bigger.Put(bucket.Get());
+		bucket = std::move(bigger);
+	}
+	bucket.Put(entry);
+}
+
+template<class T>
+inline void TTimerWheel<T>::Cascade(size_t level)
+{
+	TQueue<TEntry>& bucket = buckets[level][(now >> (SLOT_BITS * level)) & (SLOTS - 1)];
+	for (size_t pending = bucket.GetSize(); pending > 0; --pending) {
+		TEntry entry = bucket.Get();
+		const TRecord& record = records[entry.index];
+		if (record.active && record.generation == entry.generation) Insert(entry);
+	}
+}
+
+template<class T>
+inline void TTimerWheel<T>::Release(size_t index)
+{
+	TRecord& record = records[index];
+	record.active = false;
+	record.generation++;
+	free_records.PushBack(index);
+	count--;
+}
+
+template<class T>
+template<class F>
+inline size_t TTimerWheel<T>::Expire(F& expire)
+{
+	TQueue<TEntry>& bucket = buckets[0][now & (SLOTS - 1)];
+	size_t expired = 0;
+	for (size_t pending = bucket.GetSize(); pending > 0; --pending) {
+		TEntry entry = bucket.Get();
+		TRecord& record = records[entry.index];
+		if (!record.active || record.generation != entry.generation) continue;
+
+		T value = std::move(record.value);
+		Release(entry.index);
+		expired++;
+		expire(value);
+	}
+	return expired;
+}
+
+template<class T>
+inline uint64_t TTimerWheel<T>::GetTime() const
+{
+	return now;
+}
+
+template<class T>
+inline size_t TTimerWheel<T>::GetSize() const
+{
+	return count;
+}
+
+template<class T>
+inline bool TTimerWheel<T>::IsEmpty() const
+{
+	return count == 0;
+}
+
+// The timer fires on the delay-th tick from now; delay 0 fires on the next tick.
+template<class T>
+inline TTimerHandle TTimerWheel<T>::Schedule(uint64_t delay, const T& value)
+{
+	if (delay == 0) delay = 1;
+	if (delay > UINT64_MAX - now) throw TError("Delay is too large", __func__, __FILE__, __LINE__);
+
+	size_t index;
+	if (!free_records.IsEmpty()) index = free_records.PopBack();
+	else {
+		index = records.GetSize();
+		records.PushBack(TRecord{ T(), 0, 0, false });
+	}
+
+	TRecord& record = records[index];
+	record.value = value;
+	record.deadline = now + delay;
+	record.active = true;
+	count++;
+
+	TEntry entry = { index, record.generation };
+	Insert(entry);
+	return TTimerHandle{ index, record.generation };
+}
+
+template<class T>
+inline bool TTimerWheel<T>::Cancel(const TTimerHandle& handle)
+{
+	if (!IsScheduled(handle)) return false;
+	Release(handle.index);
+	return true;
+}
+
+template<class T>
+inline bool TTimerWheel<T>::IsScheduled(const TTimerHandle& handle) const
+{
+	if (handle.index >= records.GetSize()) return false;
+	const TRecord& record = records[handle.index];
+	return record.active && record.generation == handle.generation;
+}
+
+template<class T>
+inline uint64_t TTimerWheel<T>::GetDeadline(const TTimerHandle& handle) const
+{
+	if (!IsScheduled(handle)) throw TError("Timer is not scheduled", __func__, __FILE__, __LINE__);
+	return records[handle.index].deadline;
+}
+
+template<class T>
+template<class F>
+inline size_t TTimerWheel<T>::Tick(F expire)
+{
+	now++;
+	for (size_t level = 1; level < LEVELS; ++level) {
+		if ((now & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0) break;
+		Cascade(level);
+	}
+	return Expire(expire);
+}
+
+// Runs ticks one by one, so timers expire in deadline order across buckets.
+// While no timer is scheduled the clock jumps ahead without visiting buckets.
+template<class T>
+template<class F>
+inline size_t TTimerWheel<T>::Advance(uint64_t ticks, F expire)
+{
+	size_t expired = 0;
+	for (uint64_t i = 0; i < ticks; ++i) {
+		if (count == 0) {
+			now += ticks - i;
+			break;
+		}
+		expired += Tick<F&>(expire);
+	}
+	return expired;
+}
@@ -150,7 +150,7 @@ inline TVector<T>::TVector(const TVector& other)
 	{
 		capacity = other.capacity;
 		size = other.size;
-		data = new T[size]{};
+		data = new T[capacity]{};
 		for (auto i = 0; i < size; i++) data[i] = other.data[i];
 	}
 	else
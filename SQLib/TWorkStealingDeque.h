@@ -0,0 +1,148 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "TError.hpp"
+#include "TVector_AdvImp.h"
+
+// Chase-Lev work-stealing deque (memory orders after Le, Pop, Cohen, Zappa Nardelli,
+// "Correct and Efficient Work-Stealing for Weak Memory Models", 2013).
+// The owner thread calls Push and Pop at the bottom; any thread may call Steal,
+// which takes from the top. The circular array grows when full; old arrays are kept
+// until the deque is destroyed because a thief may still be reading them.
+template<class T>
+class TWorkStealingDeque {
+	static_assert(std::is_trivially_copyable<T>::value, "TWorkStealingDeque stores T in std::atomic");
+
+protected:
+	static constexpr size_t CACHE_LINE = 64;
+
+	struct TArray {
+		int64_t capacity;
+		int64_t mask;
+		std::atomic<T>* items;
+
+		TArray(int64_t capacity_) : capacity(capacity_), mask(capacity_ - 1), items(new std::atomic<T>[capacity_]) {}
+		~TArray() { delete[] items; }
+
+		T Load(int64_t index) const { return items[index & mask].load(std::memory_order_relaxed); }
+		void Store(int64_t index, const T& value) { items[index & mask].store(value, std::memory_order_relaxed); }
+	};
+
+	alignas(CACHE_LINE) std::atomic<int64_t> top;
+	alignas(CACHE_LINE) std::atomic<int64_t> bottom;
+	alignas(CACHE_LINE) std::atomic<TArray*> array;
+	TVector<TArray*> retired;
+
+	TArray* Grow(TArray* old_array, int64_t old_bottom, int64_t old_top);
+
+public:
+	TWorkStealingDeque(size_t capacity_ = 64);
+	TWorkStealingDeque(const TWorkStealingDeque<T>& other) = delete;
+	TWorkStealingDeque& operator=(const TWorkStealingDeque<T>& other) = delete;
+	~TWorkStealingDeque();
+
+	size_t GetSize() const;
+	size_t GetCapacity() const;
+	bool IsEmpty() const;
+
+	void Push(const T& value);
+	bool Pop(T& value);
+	bool Steal(T& value);
+};
+
+template<class T>
+inline TWorkStealingDeque<T>::TWorkStealingDeque(size_t capacity_) : top(0), bottom(0)
+{
+	int64_t capacity = 2;
+	while (capacity < static_cast<int64_t>(capacity_)) capacity *= 2;
+	array.store(new TArray(capacity), std::memory_order_relaxed);
+}
+
+template<class T>
+inline TWorkStealingDeque<T>::~TWorkStealingDeque()
+{
+	delete array.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < retired.GetSize(); ++i) delete retired[i];
+}
+
+template<class T>
+inline typename TWorkStealingDeque<T>::TArray* TWorkStealingDeque<T>::Grow(TArray* old_array, int64_t old_bottom, int64_t old_top)
+{
+	TArray* new_array = new TArray(old_array->capacity * 2);
+	for (int64_t i = old_top; i < old_bottom; ++i) new_array->Store(i, old_array->Load(i));
+	retired.push_back(old_array);
+	array.store(new_array, std::memory_order_release);
+	return new_array;
+}
+
+template<class T>
+inline size_t TWorkStealingDeque<T>::GetSize() const
+{
+	int64_t b = bottom.load(std::memory_order_relaxed);
+	int64_t t = top.load(std::memory_order_relaxed);
+	return b > t ? static_cast<size_t>(b - t) : 0;
+}
+
+template<class T>
+inline size_t TWorkStealingDeque<T>::GetCapacity() const
+{
+	return static_cast<size_t>(array.load(std::memory_order_relaxed)->capacity);
+}
+
+template<class T>
+inline bool TWorkStealingDeque<T>::IsEmpty() const
+{
+	return GetSize() == 0;
+}
+
+template<class T>
+inline void TWorkStealingDeque<T>::Push(const T& value)
+{
+	int64_t b = bottom.load(std::memory_order_relaxed);
+	int64_t t = top.load(std::memory_order_acquire);
+	TArray* a = array.load(std::memory_order_relaxed);
+	if (b - t > a->capacity - 1) a = Grow(a, b, t);
+	a->Store(b, value);
+	std::atomic_thread_fence(std::memory_order_release);
+	bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+template<class T>
+inline bool TWorkStealingDeque<T>::Pop(T& value)
+{
+	int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+	TArray* a = array.load(std::memory_order_relaxed);
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = top.load(std::memory_order_relaxed);
+
+	if (t > b) {
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	value = a->Load(b);
+	if (t == b) {
+		bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return won;
+	}
+	return true;
+}
+
+template<class T>
+inline bool TWorkStealingDeque<T>::Steal(T& value)
+{
+	int64_t t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t b = bottom.load(std::memory_order_acquire);
+	if (t >= b) return false;
+
+	TArray* a = array.load(std::memory_order_acquire);
+	T candidate = a->Load(t);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return false;
+	value = candidate;
+	return true;
+}
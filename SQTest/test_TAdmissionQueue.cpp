@@ -0,0 +1,174 @@
+#include <gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include "TAdmissionQueue.h"
+
+using namespace std::chrono;
+
+// Тест пополнения корзины токенов
+TEST(TTokenBucketTest, RefillsAtRate) {
+  auto start = TTokenBucket::TClock::now();
+  TTokenBucket bucket(10, 2, start);
+  EXPECT_TRUE(bucket.TryTake(start));
+  EXPECT_TRUE(bucket.TryTake(start));
+  EXPECT_FALSE(bucket.TryTake(start));
+  EXPECT_GT(bucket.TimeToToken(start), milliseconds(99));
+  EXPECT_LE(bucket.TimeToToken(start), milliseconds(101));
+
+  EXPECT_FALSE(bucket.TryTake(start + milliseconds(50)));
+  EXPECT_TRUE(bucket.TryTake(start + milliseconds(100)));
+  EXPECT_NEAR(bucket.GetTokens(start + seconds(10)), 2.0, 1e-9);
+}
+
+// Тест корзины без ограничения
+TEST(TTokenBucketTest, Unlimited) {
+  TTokenBucket bucket;
+  EXPECT_TRUE(bucket.IsUnlimited());
+  for (int i = 0; i < 1000; ++i) EXPECT_TRUE(bucket.TryTake());
+  EXPECT_EQ(bucket.TimeToToken(), TTokenBucket::TClock::duration::zero());
+}
+
+// Тест конструктора с некорректными параметрами
+TEST(TAdmissionQueueTest, InvalidConstruction) {
+  EXPECT_ANY_THROW(TAdmissionQueue<int>(0, TOverflowPolicy::DropNewest));
+  EXPECT_ANY_THROW(TAdmissionQueue<int>(4, TOverflowPolicy::SpillToDisk));
+}
+
+// Тест политики вытеснения старейшего элемента
+TEST(TAdmissionQueueTest, DropOldest) {
+  TAdmissionQueue<int> queue(3, TOverflowPolicy::DropOldest);
+  for (int i = 0; i < 3; ++i) EXPECT_EQ(queue.Put(i), TAdmission::Accepted);
+  EXPECT_EQ(queue.Put(3), TAdmission::DroppedOldest);
+  EXPECT_EQ(queue.Put(4), TAdmission::DroppedOldest);
+
+  int value;
+  for (int i = 2; i < 5; ++i) {
+    EXPECT_TRUE(queue.TryGet(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.TryGet(value));
+
+  TAdmissionCounters counters = queue.GetCounters();
+  EXPECT_EQ(counters.accepted, 3);
+  EXPECT_EQ(counters.dropped_oldest, 2);
+}
+
+// Тест политики отбрасывания нового элемента
+TEST(TAdmissionQueueTest, DropNewest) {
+  TAdmissionQueue<int> queue(2, TOverflowPolicy::DropNewest);
+  EXPECT_EQ(queue.Put(1), TAdmission::Accepted);
+  EXPECT_EQ(queue.Put(2), TAdmission::Accepted);
+  EXPECT_EQ(queue.Put(3), TAdmission::DroppedNewest);
+
+  int value;
+  EXPECT_TRUE(queue.TryGet(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_EQ(queue.GetCounters().dropped_newest, 1);
+}
+
+// Тест ограничения скорости
+TEST(TAdmissionQueueTest, RateLimited) {
+  TAdmissionQueue<int> queue(10, TOverflowPolicy::DropNewest, 0.001, 3);
+  for (int i = 0; i < 3; ++i) EXPECT_EQ(queue.Put(i), TAdmission::Accepted);
+  EXPECT_EQ(queue.Put(3), TAdmission::RateLimited);
+  EXPECT_EQ(queue.GetSize(), 3);
+  EXPECT_EQ(queue.GetCounters().rate_limited, 1);
+}
+
+// Тест блокирующей политики при переполнении
+TEST(TAdmissionQueueTest, BlockWaitsForSpace) {
+  TAdmissionQueue<int> queue(1, TOverflowPolicy::Block);
+  EXPECT_EQ(queue.Put(1), TAdmission::Accepted);
+
+  std::thread producer([&queue] { EXPECT_EQ(queue.Put(2), TAdmission::Accepted); });
+  while (queue.GetCounters().blocked == 0) std::this_thread::yield();
+
+  int value;
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_EQ(value, 1);
+  producer.join();
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_EQ(value, 2);
+}
+
+// Тест блокирующей политики при ограничении скорости
+TEST(TAdmissionQueueTest, BlockWaitsForToken) {
+  TAdmissionQueue<int> queue(10, TOverflowPolicy::Block, 100, 1);
+  auto start = steady_clock::now();
+  for (int i = 0; i < 3; ++i) EXPECT_EQ(queue.Put(i), TAdmission::Accepted);
+  EXPECT_GE(steady_clock::now() - start, milliseconds(15));
+  EXPECT_EQ(queue.GetCounters().blocked, 2);
+}
+
+// Тест: закрытие будит заблокированного производителя
+TEST(TAdmissionQueueTest, CloseWakesBlockedPut) {
+  TAdmissionQueue<int> queue(1, TOverflowPolicy::Block);
+  queue.Put(1);
+  std::thread producer([&queue] { EXPECT_EQ(queue.Put(2), TAdmission::Closed); });
+  while (queue.GetCounters().blocked == 0) std::this_thread::yield();
+  queue.Close();
+  producer.join();
+
+  int value;
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_FALSE(queue.Get(value));
+  EXPECT_EQ(queue.Put(3), TAdmission::Closed);
+}
+
+// Тест сброса на диск с сохранением порядка
+TEST(TAdmissionQueueTest, SpillToDiskKeepsOrder) {
+  const std::string path = "admission_spill.txt";
+  {
+    TAdmissionQueue<double> queue(2, TOverflowPolicy::SpillToDisk, 0, 1, path);
+    EXPECT_EQ(queue.Put(0.5), TAdmission::Accepted);
+    EXPECT_EQ(queue.Put(1.25), TAdmission::Accepted);
+    EXPECT_EQ(queue.Put(0.1), TAdmission::Spilled);
+    EXPECT_EQ(queue.Put(3.0), TAdmission::Spilled);
+    EXPECT_EQ(queue.GetSize(), 4);
+    EXPECT_EQ(queue.GetSpilledSize(), 2);
+
+    double value;
+    EXPECT_TRUE(queue.TryGet(value));
+    EXPECT_EQ(value, 0.5);
+    EXPECT_EQ(queue.Put(4.0), TAdmission::Spilled);
+
+    double expected[] = { 1.25, 0.1, 3.0, 4.0 };
+    for (double e : expected) {
+      EXPECT_TRUE(queue.Get(value));
+      EXPECT_EQ(value, e);
+    }
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_EQ(queue.Put(5.0), TAdmission::Accepted);
+
+    TAdmissionCounters counters = queue.GetCounters();
+    EXPECT_EQ(counters.spilled, 3);
+    EXPECT_EQ(counters.unspilled, 3);
+  }
+  EXPECT_EQ(std::fopen(path.c_str(), "r"), nullptr);
+}
+
+// Тест: при ограничении скорости элемент отклоняется, а не сбрасывается на
+// диск, иначе он вернулся бы в очередь без токена
+TEST(TAdmissionQueueTest, SpillRespectsRateLimit) {
+  const std::string path = "admission_rate_spill.txt";
+  TAdmissionQueue<int> queue(1, TOverflowPolicy::SpillToDisk, 0.001, 2, path);
+  EXPECT_EQ(queue.Put(1), TAdmission::Accepted);
+  EXPECT_EQ(queue.Put(2), TAdmission::Spilled);
+  EXPECT_EQ(queue.Put(3), TAdmission::RateLimited);
+  EXPECT_EQ(queue.GetSpilledSize(), 1);
+
+  int value;
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_EQ(queue.Put(4), TAdmission::RateLimited);
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_EQ(value, 2);
+  EXPECT_TRUE(queue.IsEmpty());
+
+  TAdmissionCounters counters = queue.GetCounters();
+  EXPECT_EQ(counters.accepted, 1);
+  EXPECT_EQ(counters.spilled, 1);
+  EXPECT_EQ(counters.rate_limited, 2);
+  EXPECT_EQ(std::fopen(path.c_str(), "r"), nullptr);
+}
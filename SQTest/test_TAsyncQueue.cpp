@@ -0,0 +1,143 @@
+#include <gtest.h>
+#include <stdexcept>
+#include <vector>
+#include "TAsyncQueue.h"
+#include "TExecutor.h"
+
+namespace {
+
+TAsyncTask Produce(TAsyncQueue<int>& queue, int first, int last) {
+  for (int i = first; i < last; ++i) co_await queue.Put(i);
+}
+
+TAsyncTask Consume(TAsyncQueue<int>& queue, int count, std::vector<int>& result) {
+  for (int i = 0; i < count; ++i) result.push_back(co_await queue.Get());
+}
+
+TAsyncTask Throw(TAsyncQueue<int>& queue) {
+  co_await queue.Get();
+  throw std::runtime_error("task failed");
+}
+
+}
+
+// Тест: задача не выполняется до запуска исполнителя
+TEST(TAsyncQueueTest, SpawnIsLazy) {
+  TExecutor executor;
+  TAsyncQueue<int> queue(executor, 4);
+  executor.Spawn(Produce(queue, 0, 3));
+  EXPECT_EQ(executor.GetCountTasks(), 1);
+  EXPECT_TRUE(queue.IsEmpty());
+
+  EXPECT_EQ(executor.Run(), 1);
+  EXPECT_EQ(executor.GetCountTasks(), 0);
+  EXPECT_EQ(queue.GetSize(), 3);
+}
+
+// Тест: потребитель ждет на пустой очереди и просыпается после Put
+TEST(TAsyncQueueTest, GetSuspendsUntilPut) {
+  TExecutor executor;
+  TAsyncQueue<int> queue(executor, 4);
+  std::vector<int> result;
+
+  executor.Spawn(Consume(queue, 2, result));
+  executor.Run();
+  EXPECT_TRUE(result.empty());
+  EXPECT_EQ(queue.GetCountGetters(), 1);
+
+  EXPECT_TRUE(queue.TryPut(7));
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_EQ(executor.GetCountReady(), 1);
+  EXPECT_TRUE(queue.TryPut(8));
+  executor.Run();
+
+  EXPECT_EQ(result, std::vector<int>({ 7, 8 }));
+  EXPECT_EQ(executor.GetCountTasks(), 0);
+}
+
+// Тест: производитель ждет на полной очереди
+TEST(TAsyncQueueTest, PutSuspendsWhenFull) {
+  TExecutor executor;
+  TAsyncQueue<int> queue(executor, 2);
+  executor.Spawn(Produce(queue, 0, 5));
+  executor.Run();
+  EXPECT_TRUE(queue.IsFull());
+  EXPECT_EQ(queue.GetCountPutters(), 1);
+
+  int value = -1;
+  EXPECT_TRUE(queue.TryGet(value));
+  EXPECT_EQ(value, 0);
+  EXPECT_TRUE(queue.IsFull());
+  executor.Run();
+
+  for (int i = 1; i < 5; ++i) {
+    EXPECT_TRUE(queue.TryGet(value));
+    EXPECT_EQ(value, i);
+    executor.Run();
+  }
+  EXPECT_FALSE(queue.TryGet(value));
+  EXPECT_EQ(executor.GetCountTasks(), 0);
+}
+
+// Тест нескольких производителей и потребителей
+TEST(TAsyncQueueTest, ManyProducersConsumers) {
+  TExecutor executor;
+  TAsyncQueue<int> queue(executor, 3);
+  std::vector<int> first, second;
+
+  executor.Spawn(Consume(queue, 50, first));
+  executor.Spawn(Consume(queue, 50, second));
+  executor.Spawn(Produce(queue, 0, 50));
+  executor.Spawn(Produce(queue, 50, 100));
+  executor.Run();
+
+  EXPECT_EQ(executor.GetCountTasks(), 0);
+  EXPECT_EQ(first.size() + second.size(), 100);
+  std::vector<int> all(first);
+  all.insert(all.end(), second.begin(), second.end());
+  std::vector<bool> seen(100, false);
+  for (int value : all) seen[value] = true;
+  for (bool flag : seen) EXPECT_TRUE(flag);
+}
+
+// Тест небуферизованного канала
+TEST(TAsyncQueueTest, ZeroCapacityRendezvous) {
+  TExecutor executor;
+  TAsyncQueue<int> queue(executor, 0);
+  std::vector<int> result;
+
+  executor.Spawn(Produce(queue, 0, 10));
+  executor.Run();
+  EXPECT_EQ(queue.GetCountPutters(), 1);
+  EXPECT_TRUE(queue.IsEmpty());
+
+  executor.Spawn(Consume(queue, 10, result));
+  executor.Run();
+  EXPECT_EQ(result.size(), 10);
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(result[i], i);
+}
+
+// Тест: исключение из задачи выбрасывается из Run
+TEST(TAsyncQueueTest, ExceptionPropagates) {
+  TExecutor executor;
+  TAsyncQueue<int> queue(executor, 1);
+  executor.Spawn(Throw(queue));
+  executor.Run();
+  queue.TryPut(1);
+  EXPECT_THROW(executor.Run(), std::runtime_error);
+  EXPECT_EQ(executor.GetCountTasks(), 0);
+}
+
+// Тест: исполнитель уничтожает незавершенные задачи
+TEST(TAsyncQueueTest, ExecutorDestroysSuspendedTasks) {
+  std::vector<int> result;
+  {
+    TExecutor executor;
+    TAsyncQueue<int> queue(executor, 1);
+    executor.Spawn(Consume(queue, 5, result));
+    executor.Spawn(Consume(queue, 5, result));
+    executor.Run();
+    EXPECT_EQ(executor.GetCountTasks(), 2);
+  }
+  EXPECT_TRUE(result.empty());
+}
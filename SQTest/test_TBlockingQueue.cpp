@@ -0,0 +1,147 @@
+#include <gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "TBlockingQueue.h"
+
+// Тест простых Put/Get в одном потоке
+TEST(TBlockingQueueTest, PutAndGet) {
+  TBlockingQueue<int> queue(3);
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_EQ(queue.GetCapacity(), 3);
+
+  EXPECT_TRUE(queue.Put(1));
+  EXPECT_TRUE(queue.Put(2));
+  EXPECT_EQ(queue.GetSize(), 2);
+
+  int value = 0;
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_EQ(value, 2);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+// Тест неблокирующих операций
+TEST(TBlockingQueueTest, TryPutTryGet) {
+  TBlockingQueue<int> queue(2);
+  int value = 0;
+
+  EXPECT_FALSE(queue.TryGet(value));
+  EXPECT_TRUE(queue.TryPut(1));
+  EXPECT_TRUE(queue.TryPut(2));
+  EXPECT_FALSE(queue.TryPut(3));
+  EXPECT_TRUE(queue.IsFull());
+
+  EXPECT_TRUE(queue.TryGet(value));
+  EXPECT_EQ(value, 1);
+}
+
+// Тест ожидания с таймаутом
+TEST(TBlockingQueueTest, TimedWait) {
+  TBlockingQueue<int> queue(1);
+  int value = 0;
+
+  EXPECT_FALSE(queue.GetFor(value, std::chrono::milliseconds(10)));
+  EXPECT_TRUE(queue.PutFor(5, std::chrono::milliseconds(10)));
+  EXPECT_FALSE(queue.PutFor(6, std::chrono::milliseconds(10)));
+  EXPECT_TRUE(queue.GetFor(value, std::chrono::milliseconds(10)));
+  EXPECT_EQ(value, 5);
+}
+
+// Тест закрытия: оставшиеся элементы выдаются, новые не принимаются
+TEST(TBlockingQueueTest, CloseDrainsRemaining) {
+  TBlockingQueue<int> queue(3);
+  queue.Put(1);
+  queue.Put(2);
+  queue.Close();
+
+  EXPECT_TRUE(queue.IsClosed());
+  EXPECT_FALSE(queue.Put(3));
+
+  int value = 0;
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_EQ(value, 2);
+  EXPECT_FALSE(queue.Get(value));
+}
+
+// Тест пробуждения ожидающего потребителя при закрытии
+TEST(TBlockingQueueTest, CloseWakesWaitingConsumer) {
+  TBlockingQueue<int> queue(1);
+  bool result = true;
+
+  std::thread consumer([&] {
+    int value = 0;
+    result = queue.Get(value);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue.Close();
+  consumer.join();
+
+  EXPECT_FALSE(result);
+}
+
+// Тест блокировки производителя на полной очереди
+TEST(TBlockingQueueTest, PutBlocksUntilGet) {
+  TBlockingQueue<int> queue(1);
+  queue.Put(1);
+
+  std::thread producer([&] { queue.Put(2); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  int value = 0;
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_EQ(value, 1);
+  producer.join();
+  EXPECT_TRUE(queue.Get(value));
+  EXPECT_EQ(value, 2);
+}
+
+// Тест пакетных операций
+TEST(TBlockingQueueTest, Batches) {
+  TBlockingQueue<int> queue(4);
+  int input[] = { 1, 2, 3 };
+  EXPECT_EQ(queue.PutBatch(input, 3), 3);
+
+  int output[4] = {};
+  EXPECT_EQ(queue.GetBatch(output, 4), 3);
+  EXPECT_EQ(output[0], 1);
+  EXPECT_EQ(output[2], 3);
+}
+
+// Тест нескольких производителей и потребителей
+TEST(TBlockingQueueTest, ProducersConsumers) {
+  const int producers = 4;
+  const int per_producer = 1000;
+  TBlockingQueue<int> queue(8);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&] {
+      for (int i = 1; i <= per_producer; ++i) queue.Put(i);
+    });
+  }
+
+  long long sums[2] = {};
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < 2; ++c) {
+    consumers.emplace_back([&, c] {
+      int value = 0;
+      while (queue.Get(value)) sums[c] += value;
+    });
+  }
+
+  for (auto& t : threads) t.join();
+  queue.Drain();
+  queue.Close();
+  for (auto& t : consumers) t.join();
+
+  EXPECT_EQ(sums[0] + sums[1], (long long)producers * per_producer * (per_producer + 1) / 2);
+}
+
+// Тест ошибки при нулевой емкости
+TEST(TBlockingQueueTest, ZeroCapacity) {
+  EXPECT_THROW(TBlockingQueue<int> queue(0), TError);
+}
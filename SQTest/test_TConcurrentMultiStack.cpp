@@ -0,0 +1,174 @@
+#include <gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "TConcurrentMultiStack.h"
+
+// Тест конструктора
+TEST(TConcurrentMultiStackTest, Construction) {
+  TConcurrentMultiStack<int> stack(4, 3);
+  EXPECT_EQ(stack.GetCountStacks(), 4);
+  EXPECT_EQ(stack.GetCapacity_M(), 12);
+  EXPECT_EQ(stack.GetSize_M(), 0);
+  EXPECT_TRUE(stack.IsEmpty_M());
+  EXPECT_FALSE(stack.IsGrowable());
+  EXPECT_ANY_THROW(TConcurrentMultiStack<int>(0, 3));
+}
+
+// Тест однопоточных операций и перераспределения
+TEST(TConcurrentMultiStackTest, SingleThread) {
+  TConcurrentMultiStack<int> stack(3, 2);
+  for (int i = 0; i < 5; ++i) stack.Push(1, i);
+  EXPECT_EQ(stack.GetSizeOfStack(1), 5);
+  EXPECT_EQ(stack.GetSize_M(), 5);
+
+  stack.Push(0, 10);
+  EXPECT_ANY_THROW(stack.Push(2, 20));
+  EXPECT_EQ(stack.GetSize_M(), 6);
+
+  for (int i = 4; i >= 0; --i) EXPECT_EQ(stack.Pop(1), i);
+  int value = 0;
+  EXPECT_FALSE(stack.TryPop(1, value));
+  EXPECT_ANY_THROW(stack.Pop(2));
+  EXPECT_TRUE(stack.TryPop(0, value));
+  EXPECT_EQ(value, 10);
+  EXPECT_TRUE(stack.IsEmpty_M());
+  EXPECT_ANY_THROW(stack.Push(3, 0));
+}
+
+// Тест: потоки на своих стеках с частыми переполнениями
+TEST(TConcurrentMultiStackTest, ThreadsOverflowOwnStacks) {
+  const size_t count_threads = 4;
+  const int per_thread = 2000;
+  TConcurrentMultiStack<int> stack(count_threads, 4, true);
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < count_threads; ++t) {
+    threads.emplace_back([&stack, t] {
+      for (int i = 0; i < per_thread; ++i) {
+        stack.Push(t, i);
+        if (i % 3 == 2) {
+          EXPECT_EQ(stack.Pop(t), i);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_EQ(stack.GetSize_M(), count_threads * (per_thread - per_thread / 3));
+  EXPECT_GE(stack.GetCapacity_M(), stack.GetSize_M());
+  for (size_t t = 0; t < count_threads; ++t) {
+    int expected = per_thread - 1;
+    while (!stack.IsEmpty(t)) {
+      if (expected % 3 == 2) expected--;
+      EXPECT_EQ(stack.Pop(t), expected--);
+    }
+    EXPECT_EQ(expected, -1);
+  }
+}
+
+// Тест: потоки на общих стеках, сумма элементов сохраняется
+TEST(TConcurrentMultiStackTest, SharedStacksKeepElements) {
+  const size_t count_threads = 4;
+  const size_t count_stacks = 8;
+  TConcurrentMultiStack<long long> stack(count_stacks, 64);
+  std::atomic<long long> pushed(0);
+  std::atomic<long long> popped(0);
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < count_threads; ++t) {
+    threads.emplace_back([&stack, &pushed, &popped, t] {
+      unsigned seed = static_cast<unsigned>(t) + 1;
+      for (int i = 1; i <= 3000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        size_t target = (seed >> 16) % count_stacks;
+        long long value = 0;
+        if (i % 2 == 0 && stack.TryPop(target, value)) popped += value;
+        else if (stack.GetSize_M() < stack.GetCapacity_M() - count_threads) {
+          stack.Push(target, i);
+          pushed += i;
+        }
+        else if (stack.TryPop(target, value)) popped += value;
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  long long left = 0;
+  for (size_t i = 0; i < count_stacks; ++i) {
+    long long value = 0;
+    while (stack.TryPop(i, value)) left += value;
+  }
+  EXPECT_TRUE(stack.IsEmpty_M());
+  EXPECT_GT(pushed.load(), 0);
+  EXPECT_EQ(popped.load() + left, pushed.load());
+}
+
+// Тест: размер, прочитанный во время Push и Pop на одном стеке, не выходит
+// за число элементов, которые могут быть в стеке одновременно
+TEST(TConcurrentMultiStackTest, SizeWhilePushAndPopOnOneStack) {
+  const size_t count_threads = 3;
+  TConcurrentMultiStack<int> stack(2, 16);
+  std::atomic<bool> done(false);
+  size_t largest = 0;
+
+  std::thread sampler([&stack, &done, &largest] {
+    while (!done.load()) largest = std::max(largest, stack.GetSize_M());
+  });
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < count_threads; ++t) {
+    threads.emplace_back([&stack] {
+      int value = 0;
+      for (int i = 0; i < 20000; ++i) {
+        stack.Push(0, i);
+        while (!stack.TryPop(0, value)) std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  done = true;
+  sampler.join();
+
+  EXPECT_LE(largest, count_threads);
+  EXPECT_TRUE(stack.IsEmpty_M());
+}
+
+// Тест: стеки маленькие, почти каждый Push переполняет стек и идет через
+// перераспределение, пока другие потоки делают Push и Pop
+TEST(TConcurrentMultiStackTest, ThreadsOverflowSmallStacks) {
+  const size_t count_threads = 4;
+  const size_t count_stacks = 4;
+  TConcurrentMultiStack<long> stack(count_stacks, 2);
+  std::atomic<long> pushed(0);
+  std::atomic<long> popped(0);
+
+  // Каждый поток держит не больше двух элементов, поэтому все вместе
+  // не превышают вместимости 8, а отдельные стеки переполняются постоянно
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < count_threads; ++t) {
+    threads.emplace_back([&stack, &pushed, &popped, t] {
+      unsigned seed = static_cast<unsigned>(t) + 1;
+      for (long i = 1; i <= 5000; ++i) {
+        for (int k = 0; k < 2; ++k) {
+          seed = seed * 1103515245u + 12345u;
+          stack.Push((seed >> 16) % count_stacks, i);
+          pushed += i;
+        }
+        for (int k = 0; k < 2;) {
+          seed = seed * 1103515245u + 12345u;
+          long value = 0;
+          if (stack.TryPop((seed >> 16) % count_stacks, value)) {
+            popped += value;
+            ++k;
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_TRUE(stack.IsEmpty_M());
+  EXPECT_EQ(stack.GetCapacity_M(), 8);
+  EXPECT_EQ(popped.load(), pushed.load());
+}
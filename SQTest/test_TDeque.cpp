@@ -0,0 +1,122 @@
+#include <gtest.h>
+#include <deque>
+#include <random>
+#include <sstream>
+#include "TDeque.h"
+
+// Тест конструктора по умолчанию
+TEST(TDequeTest, DefaultConstructor) {
+  TDeque<int> deque;
+  EXPECT_TRUE(deque.IsEmpty());
+  EXPECT_EQ(deque.GetSize(), 0);
+  EXPECT_TRUE(deque.begin() == deque.end());
+}
+
+// Тест добавления и извлечения с обоих концов
+TEST(TDequeTest, PushPopBothEnds) {
+  TDeque<int> deque;
+  deque.PushBack(2);
+  deque.PushBack(3);
+  deque.PushFront(1);
+  deque.PushFront(0);
+
+  EXPECT_EQ(deque.GetSize(), 4);
+  EXPECT_EQ(deque.Front(), 0);
+  EXPECT_EQ(deque.Back(), 3);
+  for (size_t i = 0; i < 4; ++i) EXPECT_EQ(deque[i], (int)i);
+
+  EXPECT_EQ(deque.PopFront(), 0);
+  EXPECT_EQ(deque.PopBack(), 3);
+  EXPECT_EQ(deque.PopBack(), 2);
+  EXPECT_EQ(deque.PopFront(), 1);
+  EXPECT_TRUE(deque.IsEmpty());
+}
+
+// Тест работы через границы блоков и рост карты блоков
+TEST(TDequeTest, ManyBlocks) {
+  TDeque<int> deque;
+  const int n = (int)TDeque<int>::BLOCK_SIZE * 20;
+  for (int i = 0; i < n; ++i) {
+    deque.PushBack(i);
+    deque.PushFront(-i - 1);
+  }
+
+  EXPECT_EQ(deque.GetSize(), (size_t)2 * n);
+  EXPECT_EQ(deque[0], -n);
+  EXPECT_EQ(deque[n], 0);
+  EXPECT_EQ(deque[2 * n - 1], n - 1);
+
+  int expected = -n;
+  for (auto it = deque.begin(); it != deque.end(); ++it) EXPECT_EQ(*it, expected++);
+}
+
+// Тест скользящего окна: данные постоянно сдвигаются в одну сторону
+TEST(TDequeTest, SlidingWindow) {
+  TDeque<int> deque;
+  const int window = 10;
+  for (int i = 0; i < 100000; ++i) {
+    deque.PushBack(i);
+    if (deque.GetSize() > window) {
+      EXPECT_EQ(deque.PopFront(), i - window);
+    }
+  }
+  EXPECT_EQ(deque.GetSize(), (size_t)window);
+  EXPECT_EQ(deque.Front(), 100000 - window);
+}
+
+// Тест согласованности со std::deque на случайных операциях
+TEST(TDequeTest, MatchesStdDeque) {
+  TDeque<int> deque;
+  std::deque<int> reference;
+  std::mt19937 gen(3);
+
+  for (int i = 0; i < 20000; ++i) {
+    switch (gen() % 4) {
+    case 0: deque.PushBack(i); reference.push_back(i); break;
+    case 1: deque.PushFront(i); reference.push_front(i); break;
+    case 2:
+      if (!reference.empty()) { EXPECT_EQ(deque.PopBack(), reference.back()); reference.pop_back(); }
+      break;
+    default:
+      if (!reference.empty()) { EXPECT_EQ(deque.PopFront(), reference.front()); reference.pop_front(); }
+      break;
+    }
+  }
+  ASSERT_EQ(deque.GetSize(), reference.size());
+  for (size_t i = 0; i < reference.size(); ++i) EXPECT_EQ(deque[i], reference[i]);
+}
+
+// Тест копирования, перемещения и сравнения
+TEST(TDequeTest, CopyMoveCompare) {
+  TDeque<int> deque = { 1, 2, 3 };
+  TDeque<int> copy(deque);
+  EXPECT_TRUE(copy == deque);
+
+  copy.PushFront(0);
+  EXPECT_TRUE(copy != deque);
+
+  TDeque<int> moved(std::move(copy));
+  EXPECT_EQ(moved.GetSize(), 4);
+  EXPECT_TRUE(copy.IsEmpty());
+
+  copy = deque;
+  EXPECT_TRUE(copy == deque);
+}
+
+// Тест вывода в поток
+TEST(TDequeTest, OutputOperator) {
+  TDeque<int> deque = { 1, 2, 3 };
+  std::stringstream ss;
+  ss << deque;
+  EXPECT_EQ(ss.str(), "{ 1; 2; 3 }");
+}
+
+// Тест исключений
+TEST(TDequeTest, Exceptions) {
+  TDeque<int> deque;
+  EXPECT_THROW(deque.PopBack(), TError);
+  EXPECT_THROW(deque.PopFront(), TError);
+  EXPECT_THROW(deque.Front(), TError);
+  deque.PushBack(1);
+  EXPECT_THROW(deque[1], TError);
+}
@@ -0,0 +1,133 @@
+#include <gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "TDurableQueue.h"
+
+class TDurableQueueTest : public ::testing::Test {
+protected:
+  const std::string path = "durable_queue_test";
+
+  void RemoveFiles() {
+    std::remove((path + ".snap").c_str());
+    std::remove((path + ".snap.tmp").c_str());
+    std::remove((path + ".log").c_str());
+  }
+
+  void SetUp() override { RemoveFiles(); }
+  void TearDown() override { RemoveFiles(); }
+};
+
+// Тест восстановления очереди после перезапуска
+TEST_F(TDurableQueueTest, RestoreAfterRestart) {
+  {
+    TDurableQueue<int> queue(path, 8);
+    EXPECT_TRUE(queue.IsEmpty());
+    queue.Put(1);
+    queue.Put(2);
+    queue.Put(3);
+    EXPECT_EQ(queue.Get(), 1);
+  }
+
+  TDurableQueue<int> restored(path, 8);
+  EXPECT_EQ(restored.GetSize(), 2);
+  EXPECT_EQ(restored.Get(), 2);
+  EXPECT_EQ(restored.Get(), 3);
+  EXPECT_TRUE(restored.IsEmpty());
+}
+
+// Тест периодических контрольных точек
+TEST_F(TDurableQueueTest, Checkpoints) {
+  {
+    TDurableQueue<int> queue(path, 4, 3);
+    for (int i = 0; i < 20; ++i) {
+      queue.Put(i);
+      if (queue.GetSize() > 2) queue.Get();
+    }
+  }
+
+  TDurableQueue<int> restored(path, 4, 3);
+  EXPECT_EQ(restored.GetSize(), 2);
+  EXPECT_EQ(restored.Get(), 18);
+  EXPECT_EQ(restored.Get(), 19);
+}
+
+// Тест оборванной записи в конце журнала
+TEST_F(TDurableQueueTest, TornJournalRecord) {
+  {
+    TDurableQueue<int> queue(path, 4);
+    queue.Put(10);
+    queue.Put(20);
+  }
+  {
+    std::ofstream journal(path + ".log", std::ios::binary | std::ios::app);
+    journal.write("P\x01\x02", 3);
+  }
+
+  {
+    TDurableQueue<int> restored(path, 4);
+    EXPECT_EQ(restored.GetSize(), 2);
+    EXPECT_EQ(restored.Get(), 10);
+    restored.Put(30);
+  }
+
+  TDurableQueue<int> reopened(path, 4);
+  EXPECT_EQ(reopened.Get(), 20);
+  EXPECT_EQ(reopened.Get(), 30);
+}
+
+// Тест устаревшего журнала: снимок уже содержит его записи
+TEST_F(TDurableQueueTest, StaleJournalIgnored) {
+  std::string old_journal;
+  {
+    TDurableQueue<int> queue(path, 4);
+    queue.Put(5);
+    std::ifstream journal(path + ".log", std::ios::binary);
+    old_journal.assign(std::istreambuf_iterator<char>(journal), std::istreambuf_iterator<char>());
+    queue.Checkpoint();
+  }
+  {
+    // Сбой между записью нового снимка и очисткой журнала
+    std::ofstream journal(path + ".log", std::ios::binary | std::ios::trunc);
+    journal << old_journal;
+  }
+
+  TDurableQueue<int> restored(path, 4);
+  EXPECT_EQ(restored.GetSize(), 1);
+  EXPECT_EQ(restored.Get(), 5);
+}
+
+// Тест: снимок открывается только с той же емкостью и не больше ее
+TEST_F(TDurableQueueTest, SnapshotCapacity) {
+  {
+    TDurableQueue<int> queue(path, 4);
+    queue.Put(1);
+    queue.Put(2);
+    queue.Checkpoint();
+  }
+  EXPECT_THROW(TDurableQueue<int> larger(path, 8), TError);
+  EXPECT_THROW(TDurableQueue<int> smaller(path, 2), TError);
+
+  {
+    TDurableQueue<int> same(path, 4);
+    EXPECT_EQ(same.GetSize(), 2);
+  }
+
+  // Число элементов в снимке больше его емкости
+  {
+    std::fstream snapshot(path + ".snap", std::ios::in | std::ios::out | std::ios::binary);
+    snapshot.seekp(3 * sizeof(uint64_t));
+    uint64_t count = 5;
+    snapshot.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  }
+  EXPECT_THROW(TDurableQueue<int> corrupted(path, 4), TError);
+}
+
+// Тест исключений
+TEST_F(TDurableQueueTest, Exceptions) {
+  TDurableQueue<int> queue(path, 1);
+  EXPECT_THROW(queue.Get(), TError);
+  queue.Put(1);
+  EXPECT_THROW(queue.Put(2), TError);
+  EXPECT_THROW(TDurableQueue<int> zero(path + "_zero", 0), TError);
+}
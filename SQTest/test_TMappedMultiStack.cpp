@@ -0,0 +1,102 @@
+#include <gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "TMappedMultiStack.h"
+
+class TMappedMultiStackTest : public ::testing::Test {
+protected:
+  std::string path;
+
+  void SetUp() override {
+    path = "sqtest_mapped_multistack_" + std::to_string(getpid()) + ".bin";
+  }
+
+  void TearDown() override {
+    unlink(path.c_str());
+  }
+};
+
+// Тест создания и операций через отображение
+TEST_F(TMappedMultiStackTest, CreateAndUse) {
+  TMappedMultiStack<int> stack(path, 3, 4);
+  EXPECT_EQ(stack.GetCountStacks(), 3);
+  EXPECT_EQ(stack.GetCapacity_M(), 12);
+  EXPECT_TRUE(stack.IsEmpty_M());
+
+  for (int i = 0; i < 9; ++i) stack.Push(0, i);
+  stack.Push(2, 100);
+  EXPECT_EQ(stack.GetSizeOfStack(0), 9);
+  EXPECT_EQ(stack.GetSize_M(), 10);
+  EXPECT_EQ(stack(0, 8), 8);
+  EXPECT_EQ(stack.FindMin(), 0);
+
+  stack.Push(1, 50);
+  stack.Push(1, 51);
+  EXPECT_TRUE(stack.IsFull_M());
+  EXPECT_ANY_THROW(stack.Push(1, 52));
+  EXPECT_EQ(stack.Pop(1), 51);
+  EXPECT_EQ(stack.Pop(0), 8);
+
+  EXPECT_ANY_THROW(TMappedMultiStack<int>(path, 0, 4));
+}
+
+// Тест повторного открытия: содержимое сохраняется в файле
+TEST_F(TMappedMultiStackTest, Reopen) {
+  {
+    TMappedMultiStack<long long> stack(path, 4, 8);
+    for (long long i = 0; i < 20; ++i) stack.Push(1, i * i);
+    stack.Push(3, -1);
+    stack.Sync();
+  }
+
+  TMappedMultiStack<long long> reopened(path);
+  EXPECT_EQ(reopened.GetCountStacks(), 4);
+  EXPECT_EQ(reopened.GetCapacity_M(), 32);
+  EXPECT_EQ(reopened.GetSize_M(), 21);
+  EXPECT_EQ(reopened.GetSizeOfStack(1), 20);
+  for (long long i = 0; i < 20; ++i) EXPECT_EQ(reopened(1, static_cast<size_t>(i)), i * i);
+  EXPECT_EQ(reopened.Pop(3), -1);
+
+  for (int i = 0; i < 12; ++i) reopened.Push(0, i);
+  EXPECT_TRUE(reopened.IsFull_M());
+
+  // Обычная копия в переносимом формате
+  const std::string copy = path + ".copy";
+  reopened.SaveToFile(copy);
+  TMultiStack<long long> loaded(copy);
+  EXPECT_EQ(loaded.GetSize_M(), 32);
+  EXPECT_EQ(loaded(1, 19), 361);
+  std::remove(copy.c_str());
+}
+
+// Тест проверки файла при открытии
+TEST_F(TMappedMultiStackTest, RejectsIncorrectFile) {
+  EXPECT_THROW(TMappedMultiStack<int> stack("nonexistent_mapped.bin"), TError);
+
+  { TMappedMultiStack<int> stack(path, 2, 4); }
+  EXPECT_THROW(TMappedMultiStack<long long> stack(path), TError);
+  EXPECT_NO_THROW(TMappedMultiStack<int> stack(path));
+
+  // Обрезанный файл
+  ASSERT_EQ(truncate(path.c_str(), 100), 0);
+  EXPECT_THROW(TMappedMultiStack<int> stack(path), TError);
+
+  // Файл другого формата
+  TMultiStack<int>(2, 4).SaveToFile(path);
+  EXPECT_THROW(TMappedMultiStack<int> stack(path), TError);
+
+  // Вершина стека за началом следующего
+  {
+    TMappedMultiStack<int> stack(path, 2, 4);
+    stack.Push(0, 1);
+  }
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(64 + sizeof(size_t));
+    size_t top = 5;
+    file.write(reinterpret_cast<const char*>(&top), sizeof(top));
+  }
+  EXPECT_THROW(TMappedMultiStack<int> stack(path), TError);
+}
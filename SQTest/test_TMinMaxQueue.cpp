@@ -0,0 +1,77 @@
+#include <gtest.h>
+#include <algorithm>
+#include <deque>
+#include <random>
+#include "TMinMaxQueue.h"
+
+// Тест Put/Get и поиска минимума и максимума
+TEST(TMinMaxQueueTest, PutGetMinMax) {
+  TMinMaxQueue<int> queue;
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_FALSE(queue.IsFull());
+
+  queue.Put(5);
+  queue.Put(2);
+  queue.Put(8);
+  queue.Put(2);
+  queue.Put(7);
+
+  EXPECT_EQ(queue.GetSize(), 5);
+  EXPECT_EQ(queue.FindMin(), 2);
+  EXPECT_EQ(queue.FindMax(), 8);
+
+  EXPECT_EQ(queue.Get(), 5);
+  EXPECT_EQ(queue.Get(), 2);
+  EXPECT_EQ(queue.FindMin(), 2);  // второй экземпляр двойки еще в очереди
+  EXPECT_EQ(queue.Get(), 8);
+  EXPECT_EQ(queue.FindMax(), 7);
+  EXPECT_EQ(queue.Get(), 2);
+  EXPECT_EQ(queue.FindMin(), 7);
+}
+
+// Тест режима окна фиксированного размера
+TEST(TMinMaxQueueTest, FixedWindow) {
+  TMinMaxQueue<int> queue(3);
+  EXPECT_EQ(queue.GetWindow(), 3);
+
+  queue.Put(1);
+  queue.Put(9);
+  queue.Put(4);
+  EXPECT_TRUE(queue.IsFull());
+  EXPECT_EQ(queue.FindMin(), 1);
+
+  queue.Put(6);  // вытесняет 1
+  EXPECT_EQ(queue.GetSize(), 3);
+  EXPECT_EQ(queue.FindMin(), 4);
+  EXPECT_EQ(queue.FindMax(), 9);
+
+  queue.Put(3);  // вытесняет 9
+  EXPECT_EQ(queue.FindMin(), 3);
+  EXPECT_EQ(queue.FindMax(), 6);
+}
+
+// Тест скользящего окна против полного перебора
+TEST(TMinMaxQueueTest, MatchesBruteForce) {
+  const size_t window = 16;
+  TMinMaxQueue<int> queue(window);
+  std::deque<int> reference;
+  std::mt19937 gen(11);
+
+  for (int i = 0; i < 10000; ++i) {
+    int v = gen() % 1000;
+    queue.Put(v);
+    reference.push_back(v);
+    if (reference.size() > window) reference.pop_front();
+
+    EXPECT_EQ(queue.FindMin(), *std::min_element(reference.begin(), reference.end()));
+    EXPECT_EQ(queue.FindMax(), *std::max_element(reference.begin(), reference.end()));
+  }
+}
+
+// Тест исключений
+TEST(TMinMaxQueueTest, Exceptions) {
+  TMinMaxQueue<int> queue;
+  EXPECT_THROW(queue.Get(), TError);
+  EXPECT_THROW(queue.FindMin(), TError);
+  EXPECT_THROW(queue.FindMax(), TError);
+}
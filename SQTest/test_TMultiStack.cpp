@@ -1,7 +1,10 @@
 #include <gtest.h>
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <sstream>
+#include <vector>
 #include "TMultiStack.h"
 
 class TMultiStackTest : public ::testing::Test {
@@ -233,6 +236,253 @@ TEST_F(TMultiStackTest, Repack) {
     EXPECT_THROW(stack.Push(1, 999), TError);
 }
 
+// Тест пропорционального перераспределения: свободное место достаётся растущим стекам
+TEST_F(TMultiStackTest, RepackProportionalToGrowth) {
+    TMultiStack<int> stack(3, 10);
+    for (int i = 0; i < 10; ++i) stack.Push(0, i);
+    for (int i = 0; i < 10; ++i) stack.Push(1, 100 + i);
+    stack.Push(2, 200);
+
+    // Соседу со свободным местом пришлось бы сдвигать 11 элементов, поэтому
+    // 8 свободных мест делятся по росту стеков 11 : 10 : 1 как 4 : 3 : 1
+    stack.Push(0, 10);
+    for (int i = 11; i < 15; ++i) stack.Push(0, i);
+    EXPECT_TRUE(stack.IsFull(0));
+    for (int i = 10; i < 13; ++i) stack.Push(1, 100 + i);
+    EXPECT_TRUE(stack.IsFull(1));
+    stack.Push(2, 201);
+    EXPECT_TRUE(stack.IsFull(2));
+    EXPECT_TRUE(stack.IsFull_M());
+
+    for (int i = 14; i >= 0; --i) EXPECT_EQ(stack.Pop(0), i);
+    for (int i = 12; i >= 0; --i) EXPECT_EQ(stack.Pop(1), 100 + i);
+    EXPECT_EQ(stack.Pop(2), 201);
+    EXPECT_EQ(stack.Pop(2), 200);
+}
+
+// Тест заимствования места у ближайшего соседа со свободным местом
+TEST_F(TMultiStackTest, RepackBorrowsFromNearestNeighbour) {
+    for (int i = 0; i < 5; ++i) stack3x5.Push(1, i);
+    stack3x5.Push(1, 5);
+
+    // Стек 2 ближе по числу сдвигаемых элементов и отдаёт половину своих 5 мест
+    EXPECT_FALSE(stack3x5.IsFull(0));
+    stack3x5.Push(1, 6);
+    stack3x5.Push(1, 7);
+    EXPECT_TRUE(stack3x5.IsFull(1));
+    stack3x5.Push(2, 8);
+    stack3x5.Push(2, 9);
+    EXPECT_TRUE(stack3x5.IsFull(2));
+
+    for (int i = 7; i >= 0; --i) EXPECT_EQ(stack3x5.Pop(1), i);
+    EXPECT_EQ(stack3x5.Pop(2), 9);
+    EXPECT_EQ(stack3x5.Pop(2), 8);
+}
+
+// Тест заимствования и перераспределения на большом числе стеков
+TEST_F(TMultiStackTest, RepackManyStacks) {
+    const size_t count = 64;
+    TMultiStack<int> stack(count, 3);
+    std::vector<std::vector<int>> model(count);
+    unsigned seed = 777;
+
+    for (int step = 0; step < 20000; ++step) {
+        seed = seed * 1103515245u + 12345u;
+        size_t i = (seed >> 4) % 8 != 0 ? (seed >> 12) % 8 : (seed >> 12) % count;
+        bool push = ((seed >> 20) % 8) < 5 || model[i].empty();
+        if (push && stack.IsFull_M()) push = false;
+
+        if (push) {
+            stack.Push(i, step);
+            model[i].push_back(step);
+        } else if (!model[i].empty()) {
+            ASSERT_EQ(stack.Pop(i), model[i].back());
+            model[i].pop_back();
+        }
+    }
+
+    for (size_t k = 0; k < count; ++k) {
+        ASSERT_EQ(stack.GetSizeOfStack(k), model[k].size());
+        for (size_t j = 0; j < model[k].size(); ++j) ASSERT_EQ(stack(k, j), model[k][j]);
+    }
+}
+
+// Элемент, считающий перемещения при переупаковке
+struct TCountedMove {
+    static size_t moves;
+    int value = 0;
+
+    TCountedMove() = default;
+    TCountedMove(int value_) : value(value_) {}
+    TCountedMove(const TCountedMove& other) = default;
+    TCountedMove& operator=(const TCountedMove& other) = default;
+    TCountedMove& operator=(TCountedMove&& other) {
+        ++moves;
+        value = other.value;
+        return *this;
+    }
+};
+size_t TCountedMove::moves = 0;
+
+// Тест амортизированной стоимости переполнения одного стека: заимствование
+// через заполненные наполовину соседние стеки не должно сдвигать весь
+// растущий стек ради нескольких мест
+TEST_F(TMultiStackTest, RepackSingleHotStackMovesPerPush) {
+    const size_t count = 2000;
+    const int pushes = 30000;
+    for (size_t hot : {count - 1, count / 2}) {
+        TMultiStack<TCountedMove> stack(count, 64);
+        for (size_t k = 0; k < count; ++k) {
+            for (int j = 0; j < 32; ++j) stack.Push(k, TCountedMove(j));
+        }
+        TCountedMove::moves = 0;
+        for (int i = 0; i < pushes; ++i) stack.Push(hot, TCountedMove(i));
+
+        EXPECT_LE(TCountedMove::moves / pushes, 16u) << "hot stack " << hot;
+        ASSERT_EQ(stack.GetSizeOfStack(hot), static_cast<size_t>(pushes + 32));
+        for (int i = pushes - 1; i >= pushes - 100; --i) EXPECT_EQ(stack.Pop(hot).value, i);
+    }
+}
+
+// Тест перераспределения со сдвигом стеков в обе стороны
+TEST_F(TMultiStackTest, RepackKeepsElements) {
+    TMultiStack<int> stack(4, 4);
+    std::vector<std::vector<int>> model(4);
+    unsigned seed = 12345;
+
+    for (int step = 0; step < 2000; ++step) {
+        seed = seed * 1103515245u + 12345u;
+        size_t i = (seed >> 16) % 4;
+        bool push = ((seed >> 8) & 3) != 0 || model[i].empty();
+        if (push && stack.IsFull_M()) push = false;
+
+        if (push) {
+            stack.Push(i, step);
+            model[i].push_back(step);
+        } else if (!model[i].empty()) {
+            EXPECT_EQ(stack.Pop(i), model[i].back());
+            model[i].pop_back();
+        }
+
+        for (size_t k = 0; k < 4; ++k) {
+            ASSERT_EQ(stack.GetSizeOfStack(k), model[k].size());
+            for (size_t j = 0; j < model[k].size(); ++j) ASSERT_EQ(stack(k, j), model[k][j]);
+        }
+    }
+}
+
+// Тест роста буфера у расширяемого мультистека
+TEST_F(TMultiStackTest, GrowableGrowsWhenFull) {
+    TMultiStack<int> stack(3, 2, true);
+    EXPECT_TRUE(stack.IsGrowable());
+    EXPECT_FALSE(stack3x5.IsGrowable());
+
+    for (int i = 0; i < 6; ++i) stack.Push(i % 3, i);
+    EXPECT_TRUE(stack.IsFull_M());
+
+    stack.Push(1, 100);
+    EXPECT_EQ(stack.GetCapacity_M(), 12);
+    EXPECT_EQ(stack.GetSize_M(), 7);
+
+    for (int i = 0; i < 50; ++i) stack.Push(2, 200 + i);
+    EXPECT_EQ(stack.GetCapacity_M(), 96);
+    EXPECT_EQ(stack.GetSize_M(), 57);
+
+    for (int i = 49; i >= 0; --i) EXPECT_EQ(stack.Pop(2), 200 + i);
+    EXPECT_EQ(stack.Pop(2), 5);
+    EXPECT_EQ(stack.Pop(2), 2);
+    EXPECT_EQ(stack.Pop(1), 100);
+    EXPECT_EQ(stack.Pop(1), 4);
+    EXPECT_EQ(stack.Pop(1), 1);
+    EXPECT_EQ(stack.Pop(0), 3);
+    EXPECT_EQ(stack.Pop(0), 0);
+    EXPECT_TRUE(stack.IsEmpty_M());
+
+    TMultiStack<int> copy(stack);
+    EXPECT_TRUE(copy.IsGrowable());
+}
+
+// Тест расширяемого мультистека с нулевой начальной ёмкостью
+TEST_F(TMultiStackTest, GrowableFromZeroCapacity) {
+    TMultiStack<int> stack(4, 0, true);
+    EXPECT_TRUE(stack.IsFull(0));
+    for (int i = 0; i < 20; ++i) stack.Push(3, i);
+    EXPECT_EQ(stack.GetSizeOfStack(3), 20);
+    for (int i = 19; i >= 0; --i) EXPECT_EQ(stack.Pop(3), i);
+
+    TMultiStack<int> fixed(4, 0);
+    EXPECT_THROW(fixed.Push(0, 1), TError);
+}
+
+// Тест добавления стека в середину
+TEST_F(TMultiStackTest, AddStack) {
+    for (int i = 0; i < 4; ++i) stack3x5.Push(0, i);
+    for (int i = 0; i < 2; ++i) stack3x5.Push(1, 10 + i);
+    stack3x5.Push(2, 20);
+
+    stack3x5.AddStack(1, 4);
+    EXPECT_EQ(stack3x5.GetCountStacks(), 4);
+    EXPECT_EQ(stack3x5.GetCapacity_M(), 15);
+    EXPECT_EQ(stack3x5.GetSize_M(), 7);
+    EXPECT_TRUE(stack3x5.IsEmpty(1));
+
+    for (int i = 0; i < 4; ++i) EXPECT_NO_THROW(stack3x5.Push(1, 30 + i));
+    EXPECT_EQ(stack3x5.GetSizeOfStack(0), 4);
+    EXPECT_EQ(stack3x5(2, 1), 11);
+    EXPECT_EQ(stack3x5(3, 0), 20);
+    EXPECT_EQ(stack3x5.Pop(1), 33);
+
+    stack3x5.AddStack(4);
+    EXPECT_EQ(stack3x5.GetCountStacks(), 5);
+    stack3x5.Push(4, 40);
+    EXPECT_EQ(stack3x5(4, 0), 40);
+
+    EXPECT_THROW(stack3x5.AddStack(7), TError);
+    EXPECT_THROW(stack3x5.AddStack(0, 10), TError);
+}
+
+// Тест добавления стека в расширяемый мультистек
+TEST_F(TMultiStackTest, AddStackGrowable) {
+    TMultiStack<int> stack(2, 2, true);
+    for (int i = 0; i < 4; ++i) stack.Push(i % 2, i);
+
+    stack.AddStack(0, 5);
+    EXPECT_GE(stack.GetCapacity_M(), 9);
+    for (int i = 0; i < 5; ++i) stack.Push(0, 10 + i);
+    EXPECT_EQ(stack(1, 1), 2);
+    EXPECT_EQ(stack(2, 1), 3);
+
+    TMultiStack<int> empty;
+    empty.AddStack(0);
+    EXPECT_EQ(empty.GetCountStacks(), 1);
+    EXPECT_TRUE(empty.IsEmpty(0));
+}
+
+// Тест удаления стека
+TEST_F(TMultiStackTest, RemoveStack) {
+    for (int i = 0; i < 5; ++i) stack3x5.Push(0, i);
+    for (int i = 0; i < 3; ++i) stack3x5.Push(1, 10 + i);
+    for (int i = 0; i < 5; ++i) stack3x5.Push(2, 20 + i);
+    stack3x5.RemoveStack(1);
+    EXPECT_EQ(stack3x5.GetCountStacks(), 2);
+    EXPECT_EQ(stack3x5.GetSize_M(), 10);
+    EXPECT_EQ(stack3x5(1, 4), 24);
+
+    for (int i = 5; i < 10; ++i) stack3x5.Push(0, i);
+    EXPECT_TRUE(stack3x5.IsFull_M());
+    for (int i = 9; i >= 0; --i) EXPECT_EQ(stack3x5.Pop(0), i);
+
+    stack3x5.RemoveStack(0);
+    stack3x5.RemoveStack(0);
+    EXPECT_EQ(stack3x5.GetCountStacks(), 0);
+    EXPECT_TRUE(stack3x5.IsEmpty_M());
+    EXPECT_THROW(stack3x5.RemoveStack(0), TError);
+
+    stack3x5.AddStack(0);
+    for (int i = 0; i < 15; ++i) stack3x5.Push(0, i);
+    EXPECT_TRUE(stack3x5.IsFull_M());
+}
+
 // Тест работы с файлами
 TEST_F(TMultiStackTest, FileOperations) {
     const std::string filename = "test_stack.bin";
@@ -272,6 +522,212 @@ TEST_F(TMultiStackTest, FileOperations) {
     std::remove(filename.c_str());
 }
 
+// Тест сохранения элементов, которые нельзя копировать побайтно
+TEST(TMultiStackFileTest, StringElements) {
+    const std::string filename = "test_stack_strings.bin";
+    TMultiStack<std::string> stack(2, 3);
+    stack.Push(0, "hello");
+    stack.Push(0, "");
+    stack.Push(1, std::string(100, 'x'));
+    stack.SaveToFile(filename);
+
+    TMultiStack<std::string> loaded(filename);
+    EXPECT_EQ(loaded, stack);
+    EXPECT_EQ(loaded(0, 0), "hello");
+    EXPECT_EQ(loaded(0, 1), "");
+    EXPECT_EQ(loaded(1, 0), std::string(100, 'x'));
+    std::remove(filename.c_str());
+}
+
+static std::string ReadBytes(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::ostringstream bytes;
+    bytes << file.rdbuf();
+    return bytes.str();
+}
+
+static void WriteBytes(const std::string& filename, const std::string& bytes) {
+    std::ofstream file(filename, std::ios::binary);
+    file << bytes;
+}
+
+// Тест: длина строки из файла проверяется до выделения памяти под строку
+TEST(TMultiStackFileTest, StringLengthBeyondFile) {
+    const std::string filename = "test_stack_string_length.bin";
+    const size_t first_string = 40 + 2 * 2 * sizeof(uint64_t);
+    TMultiStack<std::string> stack(2, 3);
+    stack.Push(0, "hello");
+    stack.SaveToFile(filename);
+
+    std::string bytes = ReadBytes(filename);
+    uint64_t length = 0;
+    std::memcpy(&length, &bytes[first_string], sizeof(length));
+    ASSERT_EQ(length, 5);
+    length = uint64_t(1) << 60;
+    std::memcpy(&bytes[first_string], &length, sizeof(length));
+    WriteBytes(filename, bytes);
+    EXPECT_THROW(TMultiStack<std::string> loaded(filename), TError);
+
+    length = bytes.size();
+    std::memcpy(&bytes[first_string], &length, sizeof(length));
+    WriteBytes(filename, bytes);
+    EXPECT_THROW(TMultiStack<std::string> loaded(filename), TError);
+    std::remove(filename.c_str());
+}
+
+// Тест проверки заголовка, размеров, границ стеков и контрольной суммы
+TEST_F(TMultiStackTest, FileValidation) {
+    const std::string filename = "test_stack_corrupt.bin";
+    const size_t header_size = 40;
+    stack3x5.Push(0, 100);
+    stack3x5.Push(1, 200);
+    stack3x5.SaveToFile(filename);
+    const std::string good = ReadBytes(filename);
+    ASSERT_EQ(good.size(), header_size + 3 * 2 * sizeof(uint64_t) + 15 * sizeof(int));
+    EXPECT_NO_THROW(TMultiStack<int> loaded(filename));
+
+    // Неверная сигнатура
+    std::string bytes = good;
+    bytes[0] = 'X';
+    WriteBytes(filename, bytes);
+    EXPECT_THROW(TMultiStack<int> loaded(filename), TError);
+
+    // Неизвестная версия
+    bytes = good;
+    bytes[4] = 99;
+    WriteBytes(filename, bytes);
+    EXPECT_THROW(TMultiStack<int> loaded(filename), TError);
+
+    // Другой размер элемента
+    WriteBytes(filename, good);
+    EXPECT_THROW(TMultiStack<long long> loaded(filename), TError);
+
+    // Обрезанный файл
+    WriteBytes(filename, good.substr(0, good.size() - 1));
+    EXPECT_THROW(TMultiStack<int> loaded(filename), TError);
+    WriteBytes(filename, good.substr(0, 20));
+    EXPECT_THROW(TMultiStack<int> loaded(filename), TError);
+
+    // Вершина стека за началом следующего
+    bytes = good;
+    uint64_t top = 6;
+    std::memcpy(&bytes[header_size + 3 * sizeof(uint64_t)], &top, sizeof(top));
+    WriteBytes(filename, bytes);
+    EXPECT_THROW(TMultiStack<int> loaded(filename), TError);
+
+    // Испорченный элемент
+    bytes = good;
+    bytes[bytes.size() - 1] ^= 1;
+    WriteBytes(filename, bytes);
+    EXPECT_THROW(TMultiStack<int> loaded(filename), TError);
+
+    std::remove(filename.c_str());
+}
+
+// Тест загрузки файла, записанного с другим порядком байтов
+TEST_F(TMultiStackTest, FileOtherByteOrder) {
+    const std::string filename = "test_stack_swapped.bin";
+    const size_t header_size = 40;
+    stack3x5.Push(0, 100);
+    stack3x5.Push(2, 0x01020304);
+    stack3x5.SaveToFile(filename);
+    std::string bytes = ReadBytes(filename);
+
+    auto swap = [&bytes](size_t offset, size_t width) {
+        std::reverse(bytes.begin() + offset, bytes.begin() + offset + width);
+    };
+    size_t offsets[] = { 4, 6, 8, 12, 16, 24 };
+    size_t widths[] = { 2, 2, 4, 4, 8, 8 };
+    for (size_t i = 0; i < 6; ++i) swap(offsets[i], widths[i]);
+    for (size_t i = 0; i < 6; ++i) swap(header_size + i * sizeof(uint64_t), sizeof(uint64_t));
+    for (size_t i = 0; i < 15; ++i) swap(header_size + 6 * sizeof(uint64_t) + i * sizeof(int), sizeof(int));
+    uint64_t checksum = 0;
+    std::memcpy(&bytes[32], &checksum, sizeof(checksum));
+    checksum = ByteSwap(Fnv1a(bytes.data(), bytes.size()));
+    std::memcpy(&bytes[32], &checksum, sizeof(checksum));
+    WriteBytes(filename, bytes);
+
+    TMultiStack<int> loaded(filename);
+    EXPECT_EQ(loaded, stack3x5);
+    EXPECT_EQ(loaded(2, 0), 0x01020304);
+    std::remove(filename.c_str());
+}
+
+// Тест компактного сохранения: в файл попадают только элементы стеков
+TEST_F(TMultiStackTest, CompactFile) {
+    const std::string filename = "test_stack_compact.bin";
+    const size_t header_size = 40;
+    TMultiStack<int> stack(4, 100);
+    for (int i = 0; i < 30; ++i) stack.Push(1, i);
+    stack.Push(3, 7);
+    stack.SaveToFile(filename, true);
+    EXPECT_EQ(ReadBytes(filename).size(), header_size + 4 * sizeof(uint64_t) + 31 * sizeof(int));
+
+    TMultiStack<int> loaded(filename);
+    EXPECT_EQ(loaded.GetCapacity_M(), 400);
+    EXPECT_EQ(loaded.GetSize_M(), 31);
+    EXPECT_EQ(loaded.GetSizeOfStack(0), 0);
+    EXPECT_EQ(loaded.GetSizeOfStack(1), 30);
+    EXPECT_EQ(loaded.GetSizeOfStack(3), 1);
+    for (int i = 0; i < 30; ++i) EXPECT_EQ(loaded(1, i), i);
+    EXPECT_EQ(loaded(3, 0), 7);
+
+    // Свободное место поделено поровну: в каждый стек войдет еще ~92 элемента
+    for (size_t i = 0; i < 4; ++i) {
+        int pushed = 0;
+        while (!loaded.IsFull(i)) {
+            loaded.Push(i, pushed);
+            pushed++;
+        }
+        EXPECT_GE(pushed, 92);
+        EXPECT_LE(pushed, 93);
+    }
+    EXPECT_TRUE(loaded.IsFull_M());
+
+    // Компактный файл со строками
+    TMultiStack<std::string> strings(3, 4);
+    strings.Push(2, "tail");
+    strings.Push(0, "head");
+    strings.SaveToFile(filename, true);
+    TMultiStack<std::string> loaded_strings(filename);
+    EXPECT_EQ(loaded_strings.GetCapacity_M(), 12);
+    EXPECT_EQ(loaded_strings(0, 0), "head");
+    EXPECT_EQ(loaded_strings(2, 0), "tail");
+    EXPECT_EQ(loaded_strings.GetSizeOfStack(1), 0);
+
+    // Размер стека больше, чем элементов в файле
+    stack2x3.Push(0, 1);
+    stack2x3.SaveToFile(filename, true);
+    std::string bytes = ReadBytes(filename);
+    uint64_t size_of_stack = 2;
+    std::memcpy(&bytes[header_size], &size_of_stack, sizeof(size_of_stack));
+    WriteBytes(filename, bytes);
+    EXPECT_THROW(TMultiStack<int> corrupt(filename), TError);
+
+    // Подделанная вместимость: испорченный заголовок отвергается по
+    // контрольной сумме до выделения памяти, а вместимость, размер блока
+    // для которой не помещается в size_t, отвергается и с верной суммой
+    stack2x3.SaveToFile(filename, true);
+    const std::string saved = ReadBytes(filename);
+    bytes = saved;
+    uint64_t capacity = uint64_t(1) << 40;
+    std::memcpy(&bytes[16], &capacity, sizeof(capacity));
+    WriteBytes(filename, bytes);
+    EXPECT_THROW(TMultiStack<int> corrupt(filename), TError);
+
+    bytes = saved;
+    capacity = 0x4000000000000001ull;
+    uint64_t checksum = 0;
+    std::memcpy(&bytes[16], &capacity, sizeof(capacity));
+    std::memcpy(&bytes[32], &checksum, sizeof(checksum));
+    checksum = Fnv1a(bytes.data(), bytes.size());
+    std::memcpy(&bytes[32], &checksum, sizeof(checksum));
+    WriteBytes(filename, bytes);
+    EXPECT_THROW(TMultiStack<int> corrupt(filename), TError);
+
+    std::remove(filename.c_str());
+}
+
 // Тест обработки ошибок
 TEST_F(TMultiStackTest, ErrorHandling) {
     // Попытка доступа к несуществующему стеку
@@ -310,6 +766,34 @@ TEST(TMultiStackDifferentTypes, VariousTypes) {
     EXPECT_EQ(stringStack(1, 0), "world");
 }
 
+// Тест нетривиального типа при росте, добавлении и удалении стеков
+TEST(TMultiStackDifferentTypes, StringsSurviveRelayout) {
+    TMultiStack<std::string> stack(2, 1, true);
+    for (int i = 0; i < 20; ++i) stack.Push(i % 2, std::string(30, static_cast<char>('a' + i)));
+    stack.AddStack(1, 3);
+    stack.Push(1, "new");
+    stack.RemoveStack(0);
+
+    EXPECT_EQ(stack.GetCountStacks(), 2);
+    EXPECT_EQ(stack(0, 0), "new");
+    for (int i = 9; i >= 0; --i) EXPECT_EQ(stack.Pop(1), std::string(30, static_cast<char>('a' + 2 * i + 1)));
+
+    TMultiStack<std::string> copy(stack);
+    EXPECT_EQ(copy, stack);
+}
+
+// Тест выравнивания данных для типа с большим выравниванием
+TEST(TMultiStackDifferentTypes, OverAlignedType) {
+    struct alignas(128) TWide {
+        int value = 0;
+        bool operator!=(const TWide& other) const { return value != other.value; }
+    };
+    TMultiStack<TWide> stack(3, 2, true);
+    for (int i = 0; i < 10; ++i) stack.Push(1, TWide{ i });
+    EXPECT_EQ(stack(1, 9).value, 9);
+    EXPECT_EQ(stack.Pop(1).value, 9);
+}
+
 // Тест граничных случаев
 TEST_F(TMultiStackTest, EdgeCases) {
     // Стек с нулевой емкостью
@@ -378,6 +862,35 @@ TEST_F(TMultiStackTest, GetSize_M) {
     EXPECT_EQ(stack3x5.GetSize_M(), 6);
 }
 
+// Тест общего размера после Pop, копирования, перемещения и загрузки из файла
+TEST_F(TMultiStackTest, GetSize_MTracksAllOperations) {
+    for (int i = 0; i < 7; ++i) stack3x5.Push(0, i);
+    stack3x5.Push(2, 7);
+    stack3x5.Pop(0);
+    EXPECT_EQ(stack3x5.GetSize_M(), 7);
+
+    TMultiStack<int> copy(stack3x5);
+    EXPECT_EQ(copy.GetSize_M(), 7);
+
+    TMultiStack<int> moved(std::move(copy));
+    EXPECT_EQ(moved.GetSize_M(), 7);
+    EXPECT_EQ(copy.GetSize_M(), 0);
+    EXPECT_TRUE(copy.IsEmpty_M());
+
+    stack2x3 = moved;
+    EXPECT_EQ(stack2x3.GetSize_M(), 7);
+
+    const std::string filename = "test_multistack_size.dat";
+    moved.SaveToFile(filename);
+    TMultiStack<int> loaded(filename);
+    EXPECT_EQ(loaded.GetSize_M(), 7);
+    std::remove(filename.c_str());
+
+    for (int i = 0; i < 8; ++i) loaded.Push(1, i);
+    EXPECT_TRUE(loaded.IsFull_M());
+    EXPECT_EQ(loaded.GetSize_M(), 15);
+}
+
 // Тест метода GetSizeOfStack
 TEST_F(TMultiStackTest, GetSizeOfStack) {
     EXPECT_EQ(stack3x5.GetSizeOfStack(0), 0);
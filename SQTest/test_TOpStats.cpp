@@ -0,0 +1,156 @@
+#include <gtest.h>
+#include <sstream>
+#include <thread>
+#include "TOpStats.h"
+#include "TQueue.h"
+#include "TStack.h"
+
+// Тест: политика по умолчанию не увеличивает размер контейнеров
+TEST(TOpStatsTest, NoStatsAddsNothing) {
+  EXPECT_EQ(sizeof(TQueue<int>), 4 * sizeof(size_t) + sizeof(int*));
+  EXPECT_EQ(sizeof(TStack<int>), 2 * sizeof(size_t) + sizeof(int*));
+}
+
+// Тест индексов и границ корзин гистограммы
+TEST(TOpStatsTest, HistogramBuckets) {
+  for (uint64_t value = 0; value < 100000; value += 7) {
+    size_t index = THistogram::BucketIndex(value);
+    EXPECT_LE(THistogram::LowerBound(index), value);
+    EXPECT_GE(THistogram::UpperBound(index), value);
+  }
+  EXPECT_EQ(THistogram::BucketIndex(UINT64_MAX), THistogram::BUCKET_COUNT - 1);
+  EXPECT_EQ(THistogram::UpperBound(THistogram::BUCKET_COUNT - 1), UINT64_MAX);
+  EXPECT_EQ(THistogram::BucketIndex(15) + 1, THistogram::BucketIndex(16));
+}
+
+// Тест процентилей гистограммы
+TEST(TOpStatsTest, HistogramPercentiles) {
+  THistogram histogram;
+  EXPECT_EQ(histogram.Percentile(50), 0);
+  for (uint64_t value = 1; value <= 1000; ++value) histogram.Record(value);
+
+  EXPECT_EQ(histogram.GetCount(), 1000);
+  EXPECT_EQ(histogram.GetMin(), 1);
+  EXPECT_EQ(histogram.GetMax(), 1000);
+  EXPECT_DOUBLE_EQ(histogram.GetMean(), 500.5);
+  EXPECT_NEAR((double)histogram.Percentile(50), 500.0, 500.0 / THistogram::SUB_COUNT);
+  EXPECT_NEAR((double)histogram.Percentile(99), 990.0, 990.0 / THistogram::SUB_COUNT);
+  EXPECT_EQ(histogram.Percentile(100), 1000);
+}
+
+// Тест записи в гистограмму из нескольких потоков
+TEST(TOpStatsTest, HistogramConcurrentRecord) {
+  THistogram histogram;
+  std::thread threads[4];
+  for (auto& thread : threads) {
+    thread = std::thread([&histogram] {
+      for (uint64_t value = 0; value < 10000; ++value) histogram.Record(value);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_EQ(histogram.GetCount(), 40000);
+  uint64_t total = 0;
+  for (size_t i = 0; i < THistogram::BUCKET_COUNT; ++i) total += histogram.GetBucket(i);
+  EXPECT_EQ(total, 40000);
+  EXPECT_EQ(histogram.GetMax(), 9999);
+}
+
+// Тест счетчиков операций очереди
+TEST(TOpStatsTest, QueueCounters) {
+  TQueue<int, TOpStats> queue(3);
+  queue.Put(1);
+  queue.Put(2);
+  queue.Put(3);
+  EXPECT_ANY_THROW(queue.Put(4));
+  queue.Get();
+  queue.Get();
+  queue.Get();
+  EXPECT_ANY_THROW(queue.Get());
+
+  const TOpStats& stats = queue.GetStats();
+  EXPECT_EQ(stats.GetPuts(), 3);
+  EXPECT_EQ(stats.GetGets(), 3);
+  EXPECT_EQ(stats.GetFullRejections(), 1);
+  EXPECT_EQ(stats.GetEmptyRejections(), 1);
+  EXPECT_EQ(stats.GetHighWater(), 3);
+  EXPECT_EQ(stats.GetPutLatency().GetCount(), 3);
+  EXPECT_EQ(stats.GetGetLatency().GetCount(), 3);
+  EXPECT_EQ(stats.GetOccupancy().GetCount(), 6);
+  EXPECT_EQ(stats.GetOccupancy().GetBucket(0), 1);
+  EXPECT_GE(stats.GetSampleCount(), 1);
+}
+
+// Тест счетчиков операций стека
+TEST(TOpStatsTest, StackCounters) {
+  TStack<int, TOpStats> stack(2);
+  stack.Put(1);
+  stack.Put(2);
+  EXPECT_ANY_THROW(stack.Put(3));
+  EXPECT_EQ(stack.Get(), 2);
+
+  const TOpStats& stats = stack.GetStats();
+  EXPECT_EQ(stats.GetPuts(), 2);
+  EXPECT_EQ(stats.GetGets(), 1);
+  EXPECT_EQ(stats.GetFullRejections(), 1);
+  EXPECT_EQ(stats.GetEmptyRejections(), 0);
+  EXPECT_EQ(stats.GetHighWater(), 2);
+}
+
+// Тест ограничения числа отсчетов заполненности
+TEST(TOpStatsTest, OccupancySamplesRing) {
+  TOpStats stats(std::chrono::nanoseconds(0));
+  for (size_t i = 0; i < 3 * TOpStats::SAMPLE_COUNT; ++i) stats.OnPut(TOpStats::Start(), i);
+  EXPECT_EQ(stats.GetSampleCount(), TOpStats::SAMPLE_COUNT);
+  EXPECT_EQ(stats.GetHighWater(), 3 * TOpStats::SAMPLE_COUNT - 1);
+}
+
+// Тест вывода статистики в JSON
+TEST(TOpStatsTest, DumpJSON) {
+  TQueue<int, TOpStats> queue(2);
+  queue.Put(5);
+  queue.Get();
+
+  std::ostringstream out;
+  queue.GetStats().DumpJSON(out);
+  std::string json = out.str();
+  EXPECT_EQ(json.front(), '{');
+  EXPECT_EQ(json.back(), '}');
+  EXPECT_NE(json.find("\"puts\":1"), std::string::npos);
+  EXPECT_NE(json.find("\"put_latency_ns\":{\"count\":1"), std::string::npos);
+  EXPECT_NE(json.find("\"occupancy_samples\":[["), std::string::npos);
+}
+
+// Тест: копия очереди начинает статистику заново и сохраняет элементы
+TEST(TOpStatsTest, CopyStartsFreshStats) {
+  TQueue<int, TOpStats> queue(3);
+  queue.Put(1);
+  queue.Put(2);
+  TQueue<int, TOpStats> copy(queue);
+  EXPECT_TRUE(copy == queue);
+  EXPECT_EQ(copy.GetStats().GetPuts(), 0);
+  EXPECT_EQ(copy.Get(), 1);
+
+  // Присваивание тоже сбрасывает статистику приемника
+  TQueue<int, TOpStats> assigned(5);
+  assigned.Put(7);
+  assigned.Get();
+  EXPECT_ANY_THROW(assigned.Get());
+  assigned = queue;
+  EXPECT_TRUE(assigned == queue);
+  EXPECT_EQ(assigned.GetStats().GetPuts(), 0);
+  EXPECT_EQ(assigned.GetStats().GetGets(), 0);
+  EXPECT_EQ(assigned.GetStats().GetEmptyRejections(), 0);
+  EXPECT_EQ(assigned.GetStats().GetPutLatency().GetCount(), 0);
+  EXPECT_EQ(assigned.Get(), 1);
+  EXPECT_EQ(assigned.GetStats().GetGets(), 1);
+
+  TStack<int, TOpStats> stack(2);
+  stack.Put(3);
+  TStack<int, TOpStats> other(2);
+  other = stack;
+  EXPECT_EQ(other.GetStats().GetPuts(), 0);
+  stack = other;
+  EXPECT_EQ(stack.GetStats().GetPuts(), 0);
+  EXPECT_EQ(stack.Get(), 3);
+}
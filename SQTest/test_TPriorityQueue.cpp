@@ -0,0 +1,100 @@
+#include <gtest.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+#include "TPriorityQueue.h"
+
+// Тест извлечения в порядке убывания
+TEST(TPriorityQueueTest, PutAndGet) {
+  TPriorityQueue<int> queue;
+  EXPECT_TRUE(queue.IsEmpty());
+
+  int values[] = { 5, 1, 9, 3, 7, 2, 8 };
+  for (int v : values) queue.Put(v);
+  EXPECT_EQ(queue.GetSize(), 7);
+  EXPECT_EQ(queue.Top(), 9);
+
+  int expected[] = { 9, 8, 7, 5, 3, 2, 1 };
+  for (int v : expected) EXPECT_EQ(queue.Get(), v);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+// Тест пользовательского компаратора (мин-куча)
+TEST(TPriorityQueueTest, CustomCompare) {
+  TPriorityQueue<int, std::greater<int>> queue;
+  queue.Put(4);
+  queue.Put(1);
+  queue.Put(3);
+  EXPECT_EQ(queue.Get(), 1);
+  EXPECT_EQ(queue.Get(), 3);
+  EXPECT_EQ(queue.Get(), 4);
+}
+
+// Тест построения кучи из диапазона
+TEST(TPriorityQueueTest, Heapify) {
+  std::vector<int> values(1000);
+  std::mt19937 gen(42);
+  for (auto& v : values) v = gen() % 10000;
+
+  TPriorityQueue<int> queue(values.begin(), values.end());
+  EXPECT_EQ(queue.GetSize(), values.size());
+
+  std::sort(values.begin(), values.end(), std::greater<int>());
+  for (int v : values) EXPECT_EQ(queue.Get(), v);
+}
+
+// Тест изменения приоритета по дескриптору
+TEST(TPriorityQueueTest, UpdateByHandle) {
+  TPriorityQueue<int, std::greater<int>> queue;
+  size_t a = queue.Put(10);
+  size_t b = queue.Put(20);
+  size_t c = queue.Put(30);
+
+  queue.Update(c, 5);
+  EXPECT_EQ(queue.Top(), 5);
+  EXPECT_EQ(queue[c], 5);
+
+  queue.Update(c, 25);
+  EXPECT_EQ(queue.Top(), 10);
+
+  queue.Erase(a);
+  EXPECT_FALSE(queue.Contains(a));
+  EXPECT_TRUE(queue.Contains(b));
+  EXPECT_EQ(queue.Get(), 20);
+  EXPECT_EQ(queue.Get(), 25);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+// Тест согласованности со std::priority_queue на случайных операциях
+TEST(TPriorityQueueTest, MatchesStdPriorityQueue) {
+  TPriorityQueue<int> queue;
+  std::priority_queue<int> reference;
+  std::mt19937 gen(7);
+
+  for (int i = 0; i < 5000; ++i) {
+    if (reference.empty() || gen() % 3 != 0) {
+      int v = gen() % 1000;
+      queue.Put(v);
+      reference.push(v);
+    }
+    else {
+      EXPECT_EQ(queue.Get(), reference.top());
+      reference.pop();
+    }
+  }
+  EXPECT_EQ(queue.GetSize(), reference.size());
+}
+
+// Тест исключений
+TEST(TPriorityQueueTest, Exceptions) {
+  TPriorityQueue<int> queue;
+  EXPECT_THROW(queue.Get(), TError);
+  EXPECT_THROW(queue.Top(), TError);
+
+  size_t handle = queue.Put(1);
+  queue.Get();
+  EXPECT_THROW(queue.Update(handle, 2), TError);
+  EXPECT_THROW(queue.Erase(handle), TError);
+}
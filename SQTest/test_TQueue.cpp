@@ -1,5 +1,8 @@
 #include <gtest.h>
 #include <fstream>
+#include <algorithm>
+#include <sstream>
+#include <vector>
 #include "TQueue.h"
 
 class TQueueTest : public ::testing::Test {
@@ -353,6 +356,38 @@ TEST_F(TQueueTest, SaveToFile) {
   EXPECT_EQ(loaded_queue.Get(), 3);
 }
 
+//         
+TEST_F(TQueueTest, SaveToFileWrapped) {
+  TQueue<int> empty_queue(3);
+  empty_queue.SaveToFile("output.txt");
+  TQueue<int> loaded_empty("output.txt");
+  EXPECT_TRUE(loaded_empty.IsEmpty());
+  loaded_empty.Put(1);  //      
+  EXPECT_EQ(loaded_empty.Get(), 1);
+
+  TQueue<int> queue(3);
+  queue.Put(1);
+  queue.Put(2);
+  queue.Get();
+  queue.Put(3);
+  queue.Put(4);
+  queue.SaveToFile("output.txt");
+
+  TQueue<int> loaded("output.txt");
+  EXPECT_TRUE(loaded == queue);
+  EXPECT_EQ(loaded.Get(), 2);
+  EXPECT_EQ(loaded.Get(), 3);
+  EXPECT_EQ(loaded.Get(), 4);
+}
+
+//      
+TEST_F(TQueueTest, FileConstructorInconsistent) {
+  std::ofstream file("output.txt");
+  file << "4 1 1 2\n7 8";
+  file.close();
+  EXPECT_THROW(TQueue<int> queue("output.txt"), TError);
+}
+
 //   
 TEST_F(TQueueTest, FindMin) {
   TQueue<int> queue(5);
@@ -409,6 +444,115 @@ TEST_F(TQueueTest, Exceptions) {
   EXPECT_THROW(TQueue<int> queue("nonexistent.txt"), TError);
 }
 
+//      
+TEST_F(TQueueTest, LogicalIndexing) {
+  TQueue<int> queue(4);
+  queue.Put(1);
+  queue.Put(2);
+  queue.Put(3);
+  queue.Get();
+  queue.Put(4);
+  queue.Put(5);  // head=1, tail=1,  2 3 4 5     
+
+  EXPECT_EQ(queue.At(0), 2);
+  EXPECT_EQ(queue.At(1), 3);
+  EXPECT_EQ(queue.At(3), 5);
+  EXPECT_THROW(queue.At(4), TError);
+
+  queue.At(3) = 50;
+  EXPECT_EQ(queue[0], 50);
+}
+
+//    
+TEST_F(TQueueTest, RandomAccessIterators) {
+  TQueue<int> queue(5);
+  queue.Put(0);
+  queue.Put(0);
+  queue.Get();
+  queue.Get();
+  queue.Put(9);
+  queue.Put(3);
+  queue.Put(7);
+  queue.Put(1);
+  queue.Put(5);  // head=2,   data[2..4]  data[0..1]
+
+  auto it = queue.begin();
+  EXPECT_EQ(*(it + 3), 1);
+  EXPECT_EQ(it[4], 5);
+  EXPECT_EQ(queue.end() - queue.begin(), 5);
+  EXPECT_TRUE(it < queue.end());
+
+  std::sort(queue.begin(), queue.end());
+  EXPECT_EQ(queue.Get(), 1);
+  EXPECT_EQ(queue.Get(), 3);
+
+  auto pos = std::lower_bound(queue.cbegin(), queue.cend(), 7);
+  EXPECT_EQ(pos - queue.cbegin(), 1);
+  EXPECT_EQ(*pos, 7);
+
+  int sum = 0;
+  for (const auto& value : queue) sum += value;
+  EXPECT_EQ(sum, 21);
+}
+
+//     
+TEST_F(TQueueTest, Spans) {
+  TQueue<int> queue(5);
+  EXPECT_EQ(queue.Spans().GetCount(), 0);
+
+  for (int i = 1; i <= 4; ++i) queue.Put(i);
+  auto spans = queue.Spans();
+  ASSERT_EQ(spans.GetCount(), 1);
+  EXPECT_EQ(spans[0].GetSize(), 4);
+
+  queue.Get();
+  queue.Get();
+  queue.Put(5);
+  queue.Put(6);
+  queue.Put(7);
+  spans = queue.Spans();
+  ASSERT_EQ(spans.GetCount(), 2);
+  EXPECT_EQ(spans[0].GetSize(), 3);
+  EXPECT_EQ(spans[1].GetSize(), 2);
+
+  std::vector<int> values;
+  for (const auto& span : queue.Spans())
+    for (int value : span) values.push_back(value);
+  EXPECT_EQ(values, std::vector<int>({ 3, 4, 5, 6, 7 }));
+
+  queue.ForEach([](int& value) { value *= 10; });
+  const TQueue<int>& view = queue;
+  int sum = 0;
+  view.ForEachSpan([&sum](const int* first, const int* last) {
+    for (; first != last; ++first) sum += *first;
+  });
+  EXPECT_EQ(sum, 250);
+  EXPECT_EQ(queue.Get(), 30);
+}
+
+//        
+TEST_F(TQueueTest, WrappedCopyAndCompare) {
+  TQueue<int> queue(4);
+  for (int i = 0; i < 4; ++i) queue.Put(i);
+  queue.Get();
+  queue.Get();
+  queue.Put(4);
+
+  TQueue<int> copy(queue);
+  EXPECT_TRUE(copy == queue);
+  TQueue<int> assigned;
+  assigned = queue;
+  EXPECT_TRUE(assigned == queue);
+
+  copy.At(2) = 40;
+  EXPECT_TRUE(copy != queue);
+  EXPECT_EQ(queue.FindMin(), 2);
+
+  std::ostringstream out;
+  out << queue;
+  EXPECT_EQ(out.str(), "{ 2; 3; 4 }");
+}
+
 //    
 struct TestStruct {
   int value;
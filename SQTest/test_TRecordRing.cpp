@@ -0,0 +1,152 @@
+#include <gtest.h>
+#include <string>
+#include <thread>
+#include "TRecordRing.h"
+
+namespace {
+
+std::string PeekString(TRecordRing& ring) {
+  size_t size = 0;
+  const char* record = ring.Peek(size);
+  if (!record) return "<none>";
+  std::string result(record, size);
+  ring.Release();
+  return result;
+}
+
+}
+
+// Тест конструктора
+TEST(TRecordRingTest, Construction) {
+  TRecordRing ring(100);
+  EXPECT_EQ(ring.GetCapacity(), 104);
+  EXPECT_EQ(ring.GetMaxRecord(), 96);
+  EXPECT_TRUE(ring.IsEmpty());
+  EXPECT_ANY_THROW(TRecordRing(8));
+}
+
+// Тест записи и чтения записей разной длины
+TEST(TRecordRingTest, PutPeekRelease) {
+  TRecordRing ring(256);
+  EXPECT_TRUE(ring.TryPut("hello", 5));
+  EXPECT_TRUE(ring.TryPut("", 0));
+  EXPECT_TRUE(ring.TryPut("a longer message", 16));
+  EXPECT_EQ(ring.GetUsed(), 16 + 8 + 24);
+
+  EXPECT_EQ(PeekString(ring), "hello");
+  EXPECT_EQ(PeekString(ring), "");
+  EXPECT_EQ(PeekString(ring), "a longer message");
+  EXPECT_EQ(PeekString(ring), "<none>");
+  EXPECT_TRUE(ring.IsEmpty());
+  EXPECT_ANY_THROW(ring.Release());
+}
+
+// Тест резервирования и фиксации меньшего размера
+TEST(TRecordRingTest, ReserveCommit) {
+  TRecordRing ring(64);
+  EXPECT_ANY_THROW(ring.Commit(0));
+  char* place = ring.Reserve(20);
+  ASSERT_NE(place, nullptr);
+  std::memcpy(place, "abc", 3);
+  EXPECT_ANY_THROW(ring.Commit(21));
+  ring.Commit(3);
+  EXPECT_EQ(ring.GetUsed(), 16);
+  EXPECT_EQ(PeekString(ring), "abc");
+  EXPECT_ANY_THROW(ring.Reserve(57));
+}
+
+// Тест: запись не помещается в конец буфера и переносится в начало
+TEST(TRecordRingTest, WrapWithPadding) {
+  TRecordRing ring(64);
+  std::string first(20, 'x'), second(20, 'y');
+  EXPECT_TRUE(ring.TryPut(first.data(), first.size()));
+  EXPECT_TRUE(ring.TryPut(second.data(), second.size()));
+  EXPECT_FALSE(ring.TryPut("z", 1));
+
+  EXPECT_EQ(PeekString(ring), first);
+  std::string third(16, 'w');
+  EXPECT_TRUE(ring.TryPut(third.data(), third.size()));
+
+  EXPECT_EQ(PeekString(ring), second);
+  EXPECT_EQ(PeekString(ring), third);
+  EXPECT_TRUE(ring.IsEmpty());
+}
+
+// Тест: нет места с учетом выравнивающего заполнения
+TEST(TRecordRingTest, FullWithPadding) {
+  TRecordRing ring(64);
+  EXPECT_TRUE(ring.TryPut("0123456789012345678901234567890", 31));
+  EXPECT_EQ(PeekString(ring), "0123456789012345678901234567890");
+  EXPECT_TRUE(ring.TryPut("abc", 3));
+  EXPECT_EQ(ring.Reserve(40), nullptr);
+  EXPECT_NE(ring.Reserve(32), nullptr);
+  ring.Commit(32);
+  EXPECT_EQ(ring.GetUsed(), 64);
+  EXPECT_EQ(PeekString(ring), "abc");
+  EXPECT_EQ(PeekString(ring).size(), 32);
+}
+
+// Тест: запись наибольшей длины, которая не помещается ни до конца буфера,
+// ни вместе с заполнением, записывается после того, как потребитель пройдет
+// заполнение
+TEST(TRecordRingTest, MaxRecordAfterOffset) {
+  TRecordRing ring(64);
+  EXPECT_TRUE(ring.TryPut("", 0));
+  EXPECT_EQ(PeekString(ring), "");
+  EXPECT_TRUE(ring.IsEmpty());
+
+  std::string largest(ring.GetMaxRecord(), 'm');
+  EXPECT_FALSE(ring.TryPut(largest.data(), largest.size()));
+  EXPECT_EQ(PeekString(ring), "<none>");
+  EXPECT_TRUE(ring.IsEmpty());
+  EXPECT_TRUE(ring.TryPut(largest.data(), largest.size()));
+  EXPECT_EQ(ring.GetUsed(), 64);
+  EXPECT_EQ(PeekString(ring), largest);
+
+  // То же через Reserve: заполнение отменяет прежнее резервирование
+  EXPECT_TRUE(ring.TryPut("ab", 2));
+  EXPECT_EQ(PeekString(ring), "ab");
+  EXPECT_NE(ring.Reserve(4), nullptr);
+  EXPECT_EQ(ring.Reserve(ring.GetMaxRecord()), nullptr);
+  EXPECT_ANY_THROW(ring.Commit(4));
+  EXPECT_EQ(PeekString(ring), "<none>");
+  char* place = ring.Reserve(ring.GetMaxRecord());
+  ASSERT_NE(place, nullptr);
+  place[0] = 'm';
+  ring.Commit(1);
+  EXPECT_EQ(PeekString(ring), "m");
+  EXPECT_TRUE(ring.IsEmpty());
+}
+
+// Тест одного производителя и одного потребителя в разных потоках
+TEST(TRecordRingTest, ProducerConsumerThreads) {
+  const int count = 20000;
+  TRecordRing ring(512);
+
+  std::thread producer([&ring] {
+    for (int i = 0; i < count; ++i) {
+      std::string message(static_cast<size_t>(i % 37), static_cast<char>('a' + i % 26));
+      message += std::to_string(i);
+      while (!ring.TryPut(message.data(), message.size())) std::this_thread::yield();
+    }
+  });
+
+  int received = 0;
+  bool ordered = true;
+  while (received < count) {
+    size_t size;
+    const char* record = ring.Peek(size);
+    if (!record) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::string expected(static_cast<size_t>(received % 37), static_cast<char>('a' + received % 26));
+    expected += std::to_string(received);
+    if (std::string(record, size) != expected) ordered = false;
+    ring.Release();
+    received++;
+  }
+  producer.join();
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(ring.IsEmpty());
+}
@@ -0,0 +1,120 @@
+#include <gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "TShardedQueue.h"
+
+// Тест конструктора
+TEST(TShardedQueueTest, Construction) {
+  TShardedQueue<int> queue(10, 4);
+  EXPECT_EQ(queue.GetCountLanes(), 4);
+  EXPECT_EQ(queue.GetLaneCapacity(), 3);
+  EXPECT_EQ(queue.GetCapacity(), 12);
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_ANY_THROW(TShardedQueue<int>(0, 4));
+
+  TShardedQueue<int> single(5, 0);
+  EXPECT_EQ(single.GetCountLanes(), 1);
+}
+
+// Тест: элементы одного потока сохраняют порядок
+TEST(TShardedQueueTest, SingleThreadFifo) {
+  TShardedQueue<int> queue(64, 4);
+  for (int i = 0; i < 10; ++i) queue.Put(i);
+  EXPECT_EQ(queue.GetSize(), 10);
+  EXPECT_EQ(queue.GetLaneSize(queue.HomeLane()), 10);
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(queue.Get(), i);
+  EXPECT_ANY_THROW(queue.Get());
+}
+
+// Тест: переполнение полосы потока
+TEST(TShardedQueueTest, LaneFull) {
+  TShardedQueue<int> queue(8, 4);
+  EXPECT_TRUE(queue.TryPut(1));
+  EXPECT_TRUE(queue.TryPut(2));
+  EXPECT_FALSE(queue.TryPut(3));
+  EXPECT_ANY_THROW(queue.Put(3));
+}
+
+// Тест распределения по ключам и порядка внутри ключа
+TEST(TShardedQueueTest, KeyedLanes) {
+  TShardedQueue<int> queue(400, 4, TLaneSelection::RoundRobin);
+  for (int i = 0; i < 100; ++i) EXPECT_TRUE(queue.TryPut(i, i % 10));
+  for (size_t lane = 0; lane < 4; ++lane) EXPECT_LT(queue.GetLaneSize(lane), 100);
+
+  std::vector<int> last(10, -1);
+  int value;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(queue.TryGet(value));
+    EXPECT_GT(value, last[value % 10]);
+    last[value % 10] = value;
+  }
+  EXPECT_FALSE(queue.TryGet(value));
+}
+
+// Тест: очередь по кругу у каждой очереди своя, Get из другой очереди ее не сдвигает
+TEST(TShardedQueueTest, RoundRobinPerQueue) {
+  TShardedQueue<int> queue(16, 4, TLaneSelection::RoundRobin);
+  TShardedQueue<int> other(16, 4, TLaneSelection::RoundRobin);
+  for (int key = 0; key < 64; ++key) {
+    queue.TryPut(static_cast<int>(queue.LaneOf(key)), key);
+    other.TryPut(key, key);
+  }
+
+  int value = 0;
+  size_t lane = queue.HomeLane();
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_TRUE(queue.TryGet(value));
+    EXPECT_EQ(value, static_cast<int>(lane));
+    lane = (lane + 1) % 4;
+    EXPECT_TRUE(other.TryGet(value));
+  }
+}
+
+// Тест: потребитель забирает элементы из чужих полос
+TEST(TShardedQueueTest, StealFromOtherLanes) {
+  TShardedQueue<int> queue(16, 4);
+  size_t home = queue.HomeLane();
+  int key = 0;
+  while (queue.LaneOf(key) == home) ++key;
+  queue.TryPut(42, key);
+
+  int value = 0;
+  EXPECT_TRUE(queue.TryGet(value));
+  EXPECT_EQ(value, 42);
+}
+
+// Тест нескольких производителей и потребителей
+TEST(TShardedQueueTest, ConcurrentProducersConsumers) {
+  const int producers = 4, per_producer = 5000;
+  TShardedQueue<int> queue(1024, 4, TLaneSelection::RoundRobin);
+  std::atomic<int> consumed(0);
+  std::atomic<long long> sum(0);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&queue, p] {
+      for (int i = 0; i < per_producer; ++i) {
+        while (!queue.TryPut(p * per_producer + i)) std::this_thread::yield();
+      }
+    });
+  }
+  for (int c = 0; c < 2; ++c) {
+    threads.emplace_back([&] {
+      int value;
+      while (consumed.load() < producers * per_producer) {
+        if (queue.TryGet(value)) {
+          sum += value;
+          consumed++;
+        }
+        else std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  long long total = (long long)producers * per_producer;
+  EXPECT_EQ(consumed.load(), total);
+  EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+  EXPECT_TRUE(queue.IsEmpty());
+}
@@ -0,0 +1,137 @@
+#include <gtest.h>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "TSharedQueue.h"
+
+class TSharedQueueTest : public ::testing::Test {
+protected:
+  std::string path;
+
+  void SetUp() override {
+    path = (access("/dev/shm", W_OK) == 0 ? "/dev/shm/" : "./");
+    path += "sqtest_shared_queue_" + std::to_string(getpid());
+  }
+
+  void TearDown() override {
+    unlink(path.c_str());
+  }
+};
+
+// Тест Put/Get через одно отображение
+TEST_F(TSharedQueueTest, PutAndGet) {
+  TSharedQueue<int> queue(path, 3);
+  EXPECT_EQ(queue.GetCapacity(), 3);
+  EXPECT_TRUE(queue.IsEmpty());
+
+  EXPECT_TRUE(queue.TryPut(1));
+  EXPECT_TRUE(queue.TryPut(2));
+  EXPECT_TRUE(queue.TryPut(3));
+  EXPECT_FALSE(queue.TryPut(4));
+  EXPECT_TRUE(queue.IsFull());
+
+  EXPECT_EQ(queue.Get(), 1);
+  queue.Put(4);
+  EXPECT_EQ(queue.Get(), 2);
+  EXPECT_EQ(queue.Get(), 3);
+  EXPECT_EQ(queue.Get(), 4);
+
+  int value = 0;
+  EXPECT_FALSE(queue.TryGet(value));
+}
+
+// Тест двух отображений одного файла: производитель и потребитель
+TEST_F(TSharedQueueTest, TwoMappings) {
+  TSharedQueue<long long> producer(path, 16);
+  TSharedQueue<long long> consumer(path);
+  EXPECT_EQ(consumer.GetCapacity(), 16);
+
+  const long long n = 100000;
+  std::thread writer([&] {
+    for (long long i = 1; i <= n; ++i) {
+      while (!producer.TryPut(i)) std::this_thread::yield();
+    }
+  });
+
+  long long sum = 0;
+  long long value = 0;
+  for (long long received = 0; received < n;) {
+    if (consumer.TryGet(value)) {
+      EXPECT_EQ(value, received + 1);
+      sum += value;
+      ++received;
+    }
+    else std::this_thread::yield();
+  }
+  writer.join();
+
+  EXPECT_EQ(sum, n * (n + 1) / 2);
+}
+
+// Тест обмена между процессами
+TEST_F(TSharedQueueTest, BetweenProcesses) {
+  TSharedQueue<int> producer(path, 8);
+  const int n = 10000;
+
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    TSharedQueue<int> consumer(path);
+    int expected = 1;
+    int value = 0;
+    while (expected <= n) {
+      if (consumer.TryGet(value)) {
+        if (value != expected) _exit(1);
+        ++expected;
+      }
+      else std::this_thread::yield();
+    }
+    _exit(0);
+  }
+
+  for (int i = 1; i <= n; ++i) {
+    while (!producer.TryPut(i)) std::this_thread::yield();
+  }
+
+  int status = 0;
+  waitpid(child, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  EXPECT_TRUE(producer.IsEmpty());
+}
+
+// Тест исключений
+TEST_F(TSharedQueueTest, Exceptions) {
+  EXPECT_THROW(TSharedQueue<int> queue(path, 0), TError);
+  EXPECT_THROW(TSharedQueue<int> queue(path + "_missing"), TError);
+
+  TSharedQueue<int> queue(path, 1);
+  EXPECT_THROW(queue.Get(), TError);
+  queue.Put(1);
+  EXPECT_THROW(queue.Put(2), TError);
+  EXPECT_THROW(TSharedQueue<double> other(path), TError);
+}
+
+// Тест: емкость из файла, при которой размер данных переполняется и
+// совпадает с размером файла, отклоняется
+TEST_F(TSharedQueueTest, CapacityOverflow) {
+  EXPECT_THROW(TSharedQueue<int> queue(path, SIZE_MAX / sizeof(int)), TError);
+
+  { TSharedQueue<int> queue(path, 16); }
+  int fd = open(path.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  uint64_t capacity = 16 + (uint64_t(1) << 62);
+  ASSERT_EQ(pwrite(fd, &capacity, sizeof(capacity), 2 * sizeof(uint64_t)), static_cast<ssize_t>(sizeof(capacity)));
+  close(fd);
+  EXPECT_THROW(TSharedQueue<int> queue(path), TError);
+
+  capacity = 0;
+  fd = open(path.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(pwrite(fd, &capacity, sizeof(capacity), 2 * sizeof(uint64_t)), static_cast<ssize_t>(sizeof(capacity)));
+  close(fd);
+  EXPECT_THROW(TSharedQueue<int> queue(path), TError);
+}
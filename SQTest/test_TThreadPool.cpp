@@ -0,0 +1,75 @@
+#include <gtest.h>
+#include <atomic>
+#include <vector>
+#include "TThreadPool.h"
+
+static long long Fib(TThreadPool& pool, int n) {
+  if (n < 2) return n;
+  if (n < 12) return Fib(pool, n - 1) + Fib(pool, n - 2);
+  long long a = 0, b = 0;
+  pool.Invoke([&] { a = Fib(pool, n - 1); }, [&] { b = Fib(pool, n - 2); });
+  return a + b;
+}
+
+// Тест выполнения отправленных задач
+TEST(TThreadPoolTest, SubmitAndWait) {
+  TThreadPool pool(4);
+  EXPECT_EQ(pool.GetCountThreads(), 4);
+
+  std::atomic<int> counter(0);
+  for (int i = 0; i < 1000; ++i) pool.Submit([&] { counter.fetch_add(1); });
+  pool.WaitIdle();
+  EXPECT_EQ(counter.load(), 1000);
+}
+
+// Тест задач, порождающих задачи
+TEST(TThreadPoolTest, NestedSubmit) {
+  TThreadPool pool(3);
+  std::atomic<int> counter(0);
+  for (int i = 0; i < 10; ++i) {
+    pool.Submit([&] {
+      for (int j = 0; j < 10; ++j) pool.Submit([&] { counter.fetch_add(1); });
+    });
+  }
+  pool.WaitIdle();
+  EXPECT_EQ(counter.load(), 100);
+}
+
+// Тест рекурсивного fork-join
+TEST(TThreadPoolTest, RecursiveInvoke) {
+  TThreadPool pool(4);
+  EXPECT_EQ(Fib(pool, 25), 75025);
+}
+
+// Тест параллельного цикла
+TEST(TThreadPoolTest, ParallelFor) {
+  TThreadPool pool(4);
+  std::vector<int> values(10000, 0);
+  pool.ParallelFor(0, values.size(), 64, [&](size_t i) { values[i] = (int)i * 2; });
+  for (size_t i = 0; i < values.size(); ++i) EXPECT_EQ(values[i], (int)i * 2);
+
+  pool.ParallelFor(5, 5, 1, [&](size_t) { FAIL(); });
+}
+
+// Тест передачи исключения из задачи
+TEST(TThreadPoolTest, TaskException) {
+  TThreadPool pool(2);
+  pool.Submit([] { throw 42; });
+  EXPECT_THROW(pool.WaitIdle(), int);
+  EXPECT_NO_THROW(pool.WaitIdle());
+}
+
+// Тест: исключение из любой половины Invoke и ParallelFor доходит до вызывающего
+TEST(TThreadPoolTest, InvokeException) {
+  TThreadPool pool(2);
+  EXPECT_THROW(pool.Invoke([] { throw 1; }, [] {}), int);
+  EXPECT_THROW(pool.Invoke([] {}, [] { throw 2; }), int);
+  EXPECT_NO_THROW(pool.WaitIdle());
+
+  for (size_t bad = 0; bad < 64; bad += 9) {
+    EXPECT_THROW(pool.ParallelFor(0, 64, 1, [bad](size_t i) {
+      if (i == bad) throw static_cast<int>(i);
+    }), int);
+  }
+  EXPECT_NO_THROW(pool.WaitIdle());
+}
@@ -0,0 +1,146 @@
+#include <gtest.h>
+#include <map>
+#include <random>
+#include <vector>
+#include "TTimerWheel.h"
+
+// Тест срабатывания таймера в заданный тик
+TEST(TTimerWheelTest, FiresOnDeadline) {
+  TTimerWheel<int> wheel;
+  wheel.Schedule(3, 7);
+  EXPECT_EQ(wheel.GetSize(), 1);
+
+  std::vector<int> fired;
+  auto collect = [&fired](int value) { fired.push_back(value); };
+  EXPECT_EQ(wheel.Tick(collect), 0);
+  EXPECT_EQ(wheel.Tick(collect), 0);
+  EXPECT_EQ(wheel.Tick(collect), 1);
+  EXPECT_EQ(fired, std::vector<int>({ 7 }));
+  EXPECT_TRUE(wheel.IsEmpty());
+  EXPECT_EQ(wheel.GetTime(), 3);
+}
+
+// Тест: нулевая задержка срабатывает на следующем тике
+TEST(TTimerWheelTest, ZeroDelay) {
+  TTimerWheel<int> wheel(100);
+  TTimerHandle handle = wheel.Schedule(0, 1);
+  EXPECT_EQ(wheel.GetDeadline(handle), 101);
+  EXPECT_EQ(wheel.Tick([](int) {}), 1);
+}
+
+// Тест пакетного срабатывания таймеров одного тика
+TEST(TTimerWheelTest, BatchExpiry) {
+  TTimerWheel<int> wheel;
+  for (int i = 0; i < 100; ++i) wheel.Schedule(10, i);
+  std::vector<int> fired;
+  EXPECT_EQ(wheel.Advance(9, [&fired](int value) { fired.push_back(value); }), 0);
+  EXPECT_EQ(wheel.Advance(1, [&fired](int value) { fired.push_back(value); }), 100);
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(fired[i], i);
+}
+
+// Тест отмены таймера
+TEST(TTimerWheelTest, Cancel) {
+  TTimerWheel<int> wheel;
+  TTimerHandle first = wheel.Schedule(5, 1);
+  TTimerHandle second = wheel.Schedule(5, 2);
+  EXPECT_TRUE(wheel.Cancel(first));
+  EXPECT_FALSE(wheel.Cancel(first));
+  EXPECT_FALSE(wheel.IsScheduled(first));
+  EXPECT_TRUE(wheel.IsScheduled(second));
+  EXPECT_EQ(wheel.GetSize(), 1);
+
+  std::vector<int> fired;
+  wheel.Advance(10, [&fired](int value) { fired.push_back(value); });
+  EXPECT_EQ(fired, std::vector<int>({ 2 }));
+  EXPECT_FALSE(wheel.Cancel(second));
+  EXPECT_ANY_THROW(wheel.GetDeadline(second));
+}
+
+// Тест: старый дескриптор не отменяет новый таймер в той же записи
+TEST(TTimerWheelTest, StaleHandleAfterReuse) {
+  TTimerWheel<int> wheel;
+  TTimerHandle old_handle = wheel.Schedule(5, 1);
+  wheel.Cancel(old_handle);
+  TTimerHandle new_handle = wheel.Schedule(5, 2);
+  EXPECT_EQ(new_handle.index, old_handle.index);
+  EXPECT_FALSE(wheel.Cancel(old_handle));
+  EXPECT_TRUE(wheel.IsScheduled(new_handle));
+
+  int fired = 0;
+  wheel.Advance(5, [&fired](int value) { fired = value; });
+  EXPECT_EQ(fired, 2);
+}
+
+// Тест каскадирования между уровнями и таймеров за пределами колеса
+TEST(TTimerWheelTest, CascadeLevels) {
+  TTimerWheel<uint64_t> wheel(12345);
+  std::vector<uint64_t> delays = { 255, 256, 257, 65535, 65536, 70000, 1u << 24, (1u << 24) + 3 };
+  for (uint64_t delay : delays) wheel.Schedule(delay, wheel.GetTime() + delay);
+
+  size_t fired = 0;
+  wheel.Advance((1u << 24) + 10, [&](uint64_t deadline) {
+    EXPECT_EQ(deadline, wheel.GetTime());
+    fired++;
+  });
+  EXPECT_EQ(fired, delays.size());
+}
+
+// Тест таймера дальше диапазона колеса
+TEST(TTimerWheelTest, BeyondRange) {
+  TTimerWheel<int> wheel(10);
+  TTimerHandle handle = wheel.Schedule(TTimerWheel<int>::RANGE + 5, 1);
+  EXPECT_EQ(wheel.GetDeadline(handle), TTimerWheel<int>::RANGE + 15);
+  EXPECT_EQ(wheel.Advance(TTimerWheel<int>::SLOTS * TTimerWheel<int>::SLOTS, [](int) {}), 0);
+  EXPECT_TRUE(wheel.IsScheduled(handle));
+  EXPECT_ANY_THROW(wheel.Schedule(UINT64_MAX, 1));
+}
+
+// Тест: обработчик может планировать и отменять таймеры
+TEST(TTimerWheelTest, ReentrantCallback) {
+  TTimerWheel<int> wheel;
+  TTimerHandle victim = wheel.Schedule(2, -1);
+  wheel.Schedule(2, 0);
+  std::vector<int> fired;
+  wheel.Advance(20, [&](int value) {
+    fired.push_back(value);
+    wheel.Cancel(victim);
+    if (value >= 0 && value < 3) wheel.Schedule(1, value + 1);
+  });
+  EXPECT_EQ(fired, std::vector<int>({ -1, 0, 1, 2, 3 }));
+}
+
+// Тест сравнения со структурой map на случайных операциях
+TEST(TTimerWheelTest, RandomAgainstMap) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<uint64_t> delay_dist(0, 200000);
+  TTimerWheel<int> wheel;
+  std::multimap<uint64_t, int> expected;
+  std::vector<TTimerHandle> handles;
+  std::vector<uint64_t> deadlines;
+
+  for (int i = 0; i < 5000; ++i) {
+    uint64_t delay = delay_dist(gen);
+    uint64_t deadline = wheel.GetTime() + (delay == 0 ? 1 : delay);
+    handles.push_back(wheel.Schedule(delay, i));
+    deadlines.push_back(deadline);
+    expected.emplace(deadline, i);
+  }
+  for (int i = 0; i < 5000; i += 3) {
+    EXPECT_TRUE(wheel.Cancel(handles[i]));
+    auto range = expected.equal_range(deadlines[i]);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == i) {
+        expected.erase(it);
+        break;
+      }
+    }
+  }
+
+  std::vector<std::pair<uint64_t, int>> fired;
+  wheel.Advance(300000, [&](int value) { fired.emplace_back(wheel.GetTime(), value); });
+  ASSERT_EQ(fired.size(), expected.size());
+  for (const auto& item : fired) EXPECT_EQ(item.first, deadlines[item.second]);
+  for (size_t i = 1; i < fired.size(); ++i) EXPECT_LE(fired[i - 1].first, fired[i].first);
+  EXPECT_TRUE(wheel.IsEmpty());
+  EXPECT_EQ(wheel.GetTime(), 300000);
+}
@@ -0,0 +1,69 @@
+#include <gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "TWorkStealingDeque.h"
+
+// Тест операций владельца: LIFO со стороны дна
+TEST(TWorkStealingDequeTest, OwnerPushPop) {
+  TWorkStealingDeque<int> deque(4);
+  EXPECT_TRUE(deque.IsEmpty());
+
+  for (int i = 0; i < 3; ++i) deque.Push(i);
+  EXPECT_EQ(deque.GetSize(), 3);
+
+  int value = -1;
+  EXPECT_TRUE(deque.Pop(value));
+  EXPECT_EQ(value, 2);
+  EXPECT_TRUE(deque.Steal(value));  // кража идет с вершины
+  EXPECT_EQ(value, 0);
+  EXPECT_TRUE(deque.Pop(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_FALSE(deque.Pop(value));
+  EXPECT_FALSE(deque.Steal(value));
+}
+
+// Тест роста кольцевого массива
+TEST(TWorkStealingDequeTest, Grow) {
+  TWorkStealingDeque<int> deque(2);
+  for (int i = 0; i < 100; ++i) deque.Push(i);
+  EXPECT_EQ(deque.GetSize(), 100);
+  EXPECT_GE(deque.GetCapacity(), (size_t)100);
+
+  int value = -1;
+  for (int i = 99; i >= 0; --i) {
+    EXPECT_TRUE(deque.Pop(value));
+    EXPECT_EQ(value, i);
+  }
+}
+
+// Тест конкурентной кражи: каждый элемент забирается ровно один раз
+TEST(TWorkStealingDequeTest, ConcurrentSteal) {
+  const int n = 100000;
+  TWorkStealingDeque<int> deque;
+  std::vector<std::atomic<int>> taken(n);
+  for (auto& t : taken) t.store(0);
+  std::atomic<bool> done(false);
+
+  std::vector<std::thread> thieves;
+  for (int k = 0; k < 3; ++k) {
+    thieves.emplace_back([&] {
+      int value;
+      while (!done.load()) {
+        if (deque.Steal(value)) taken[value].fetch_add(1);
+        else std::this_thread::yield();
+      }
+    });
+  }
+
+  int value;
+  for (int i = 0; i < n; ++i) {
+    deque.Push(i);
+    if (i % 3 == 0 && deque.Pop(value)) taken[value].fetch_add(1);
+  }
+  while (deque.Pop(value)) taken[value].fetch_add(1);
+  done.store(true);
+  for (auto& t : thieves) t.join();
+
+  for (int i = 0; i < n; ++i) EXPECT_EQ(taken[i].load(), 1);
+}